@@ -0,0 +1,178 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#ifndef NOSYNC__ADAPTIVE_CONCURRENCY_LIMITED_REQUEST_HANDLER_IMPL_H
+#define NOSYNC__ADAPTIVE_CONCURRENCY_LIMITED_REQUEST_HANDLER_IMPL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <experimental/optional>
+#include <nosync/concurrency-limited-request-handler.h>
+#include <nosync/eclock.h>
+#include <nosync/memory-utils.h>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+
+namespace nosync
+{
+
+namespace adaptive_concurrency_limited_request_handler_impl
+{
+
+template<typename Req, typename Res>
+using concurrency_limiter = concurrency_limited_request_handler_impl::concurrency_limited_request_handler<Req, Res>;
+
+
+template<typename Req, typename Res>
+class latency_measuring_request_handler : public request_handler<Req, Res>, public std::enable_shared_from_this<latency_measuring_request_handler<Req, Res>>
+{
+public:
+    latency_measuring_request_handler(
+        event_loop &evloop, const adaptive_concurrency_limit_config &limit_config,
+        std::shared_ptr<request_handler<Req, Res>> &&base_req_handler);
+
+    void handle_request(Req &&request, std::chrono::nanoseconds timeout, result_handler<Res> &&res_handler) override;
+
+    void set_limiter(const std::shared_ptr<concurrency_limiter<Req, Res>> &limiter);
+
+private:
+    void update_min_latency(std::chrono::nanoseconds latency);
+    std::experimental::optional<std::chrono::nanoseconds> get_min_latency() const;
+    void update_limit(std::chrono::time_point<eclock> req_start_time, bool res_timed_out);
+
+    event_loop &evloop;
+    adaptive_concurrency_limit_config limit_config;
+    std::shared_ptr<request_handler<Req, Res>> base_req_handler;
+    std::weak_ptr<concurrency_limiter<Req, Res>> limiter_wptr;
+    double limit;
+    std::experimental::optional<std::chrono::nanoseconds> min_latency;
+    std::experimental::optional<std::chrono::nanoseconds> prev_min_latency;
+    std::chrono::time_point<eclock> min_latency_window_end;
+    std::chrono::time_point<eclock> last_decrease_time;
+};
+
+
+template<typename Req, typename Res>
+latency_measuring_request_handler<Req, Res>::latency_measuring_request_handler(
+    event_loop &evloop, const adaptive_concurrency_limit_config &limit_config,
+    std::shared_ptr<request_handler<Req, Res>> &&base_req_handler)
+    : evloop(evloop), limit_config(limit_config), base_req_handler(std::move(base_req_handler)), limiter_wptr(),
+    limit(limit_config.initial_limit), min_latency(), prev_min_latency(),
+    min_latency_window_end(evloop.get_etime() + limit_config.min_latency_window),
+    last_decrease_time(std::chrono::time_point<eclock>::min())
+{
+}
+
+
+template<typename Req, typename Res>
+void latency_measuring_request_handler<Req, Res>::handle_request(
+    Req &&request, std::chrono::nanoseconds timeout, result_handler<Res> &&res_handler)
+{
+    base_req_handler->handle_request(
+        std::move(request), timeout,
+        [req_handler_wptr = weak_from_that(this), req_start_time = evloop.get_etime(), res_handler = std::move(res_handler)](auto res) {
+            auto req_handler_ptr = req_handler_wptr.lock();
+            if (req_handler_ptr) {
+                req_handler_ptr->update_limit(
+                    req_start_time, !res.is_ok() && res.get_error() == std::make_error_code(std::errc::timed_out));
+            }
+
+            res_handler(std::move(res));
+        });
+}
+
+
+template<typename Req, typename Res>
+void latency_measuring_request_handler<Req, Res>::set_limiter(const std::shared_ptr<concurrency_limiter<Req, Res>> &limiter)
+{
+    limiter_wptr = limiter;
+}
+
+
+template<typename Req, typename Res>
+void latency_measuring_request_handler<Req, Res>::update_min_latency(std::chrono::nanoseconds latency)
+{
+    const auto now = evloop.get_etime();
+    if (now >= min_latency_window_end) {
+        prev_min_latency = now < min_latency_window_end + limit_config.min_latency_window
+            ? min_latency
+            : std::experimental::nullopt;
+        min_latency = std::experimental::nullopt;
+        min_latency_window_end = now + limit_config.min_latency_window;
+    }
+
+    if (latency > std::chrono::nanoseconds(0) && (!min_latency || latency < *min_latency)) {
+        min_latency = latency;
+    }
+}
+
+
+template<typename Req, typename Res>
+std::experimental::optional<std::chrono::nanoseconds> latency_measuring_request_handler<Req, Res>::get_min_latency() const
+{
+    if (min_latency && prev_min_latency) {
+        return std::min(*min_latency, *prev_min_latency);
+    }
+
+    return min_latency ? min_latency : prev_min_latency;
+}
+
+
+template<typename Req, typename Res>
+void latency_measuring_request_handler<Req, Res>::update_limit(
+    std::chrono::time_point<eclock> req_start_time, bool res_timed_out)
+{
+    const auto now = evloop.get_etime();
+    const auto latency = now - req_start_time;
+
+    if (!res_timed_out) {
+        update_min_latency(latency);
+    }
+
+    const auto cur_min_latency = get_min_latency();
+    const bool overloaded =
+        res_timed_out || (cur_min_latency && latency > *cur_min_latency * limit_config.latency_tolerance);
+    if (!overloaded) {
+        limit = std::min(limit + 1.0 / limit, static_cast<double>(limit_config.max_limit));
+    } else if (req_start_time >= last_decrease_time) {
+        limit = std::max(limit * limit_config.backoff_ratio, static_cast<double>(limit_config.min_limit));
+        last_decrease_time = now;
+    }
+
+    auto limiter_ptr = limiter_wptr.lock();
+    if (limiter_ptr) {
+        limiter_ptr->set_max_in_flight(static_cast<std::size_t>(limit));
+    }
+}
+
+}
+
+
+template<typename Req, typename Res>
+std::shared_ptr<request_handler<Req, Res>> make_adaptive_concurrency_limited_request_handler(
+    event_loop &evloop, const adaptive_concurrency_limit_config &limit_config,
+    const requests_queue_capacity &pending_requests_capacity,
+    std::shared_ptr<request_handler<Req, Res>> &&base_req_handler)
+{
+    using namespace adaptive_concurrency_limited_request_handler_impl;
+
+    if (limit_config.min_limit < 1 || limit_config.min_limit > limit_config.max_limit
+        || limit_config.initial_limit < limit_config.min_limit || limit_config.initial_limit > limit_config.max_limit) {
+        throw std::invalid_argument("invalid adaptive concurrency limits");
+    }
+    if (limit_config.min_latency_window <= std::chrono::nanoseconds(0)) {
+        throw std::invalid_argument("adaptive concurrency min latency window must be positive");
+    }
+
+    auto measuring_req_handler = std::make_shared<latency_measuring_request_handler<Req, Res>>(
+        evloop, limit_config, std::move(base_req_handler));
+    auto limiter = std::make_shared<concurrency_limiter<Req, Res>>(
+        evloop, limit_config.initial_limit, pending_requests_capacity, measuring_req_handler);
+    measuring_req_handler->set_limiter(limiter);
+
+    return limiter;
+}
+
+}
+
+#endif /* NOSYNC__ADAPTIVE_CONCURRENCY_LIMITED_REQUEST_HANDLER_IMPL_H */
@@ -0,0 +1,65 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#ifndef NOSYNC__ADAPTIVE_CONCURRENCY_LIMITED_REQUEST_HANDLER_H
+#define NOSYNC__ADAPTIVE_CONCURRENCY_LIMITED_REQUEST_HANDLER_H
+
+#include <chrono>
+#include <memory>
+#include <nosync/event-loop.h>
+#include <nosync/request-handler.h>
+#include <nosync/requests-queue.h>
+
+
+namespace nosync
+{
+
+/*!
+Configuration of adaptive concurrency limit.
+
+ - initial_limit, min_limit, max_limit - initial value and bounds of the
+limit (min_limit must be positive),
+ - latency_tolerance - ratio of response latency to the lowest observed one
+above which the underlying request_handler is considered overloaded,
+ - backoff_ratio - factor by which the limit is multiplied when overload is
+detected,
+ - min_latency_window - period of tracking the lowest latency, the lowest
+latency is taken from the current and the previous period (so it adapts to the
+underlying request_handler getting slower), latencies equal to zero (responses
+received in the same event loop iteration) are not taken into account.
+*/
+struct adaptive_concurrency_limit_config
+{
+    unsigned initial_limit;
+    unsigned min_limit;
+    unsigned max_limit;
+    double latency_tolerance;
+    double backoff_ratio;
+    std::chrono::nanoseconds min_latency_window;
+};
+
+
+/*!
+Create request_handler<> decorator with concurrency limit adjusted to observed response latency.
+
+Works like make_concurrency_limited_request_handler(), but the limit is adjusted
+with AIMD (additive increase, multiplicative decrease) algorithm, using latency
+(in event loop time) of responses from the underlying request_handler:
+ - the limit grows by 1 after "limit" responses received in time (with latency
+not exceeding the lowest one observed multiplied by latency_tolerance),
+ - the limit is multiplied by backoff_ratio on response received too late or
+timeout error, but not more than once per the latency of the requests (only
+requests forwarded after the previous decrease may trigger the next one).
+
+Requests exceeding the limit wait in a queue with the specified capacity.
+Invalid limit configuration is reported with std::invalid_argument exception.
+*/
+template<typename Req, typename Res>
+std::shared_ptr<request_handler<Req, Res>> make_adaptive_concurrency_limited_request_handler(
+    event_loop &evloop, const adaptive_concurrency_limit_config &limit_config,
+    const requests_queue_capacity &pending_requests_capacity,
+    std::shared_ptr<request_handler<Req, Res>> &&base_req_handler);
+
+}
+
+#include <nosync/adaptive-concurrency-limited-request-handler-impl.h>
+
+#endif /* NOSYNC__ADAPTIVE_CONCURRENCY_LIMITED_REQUEST_HANDLER_H */
@@ -0,0 +1,185 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#ifndef NOSYNC__CACHING_REQUEST_HANDLER_IMPL_H
+#define NOSYNC__CACHING_REQUEST_HANDLER_IMPL_H
+
+#include <iterator>
+#include <list>
+#include <map>
+#include <nosync/eclock.h>
+#include <nosync/memory-utils.h>
+#include <nosync/result-handler-utils.h>
+#include <nosync/time-utils.h>
+#include <nosync/type-utils.h>
+#include <set>
+#include <system_error>
+#include <tuple>
+#include <utility>
+
+
+namespace nosync
+{
+
+namespace caching_request_handler_impl
+{
+
+template<typename Req, typename Res, typename K>
+class lru_caching_request_handler : public caching_request_handler<Req, Res>, public std::enable_shared_from_this<lru_caching_request_handler<Req, Res, K>>
+{
+public:
+    lru_caching_request_handler(
+        event_loop &evloop, const caching_request_handler_config &config,
+        std::shared_ptr<request_handler<Req, Res>> &&base_req_handler,
+        std::function<K(const Req &)> &&cache_key_func);
+
+    void handle_request(Req &&request, std::chrono::nanoseconds timeout, result_handler<Res> &&res_handler) override;
+    caching_request_handler_stats get_stats() const override;
+
+private:
+    using cache_entry = std::tuple<K, result<Res>, std::chrono::time_point<eclock>>;
+
+    void forward_request(
+        K &&cache_key, Req &&request, std::chrono::nanoseconds timeout, bool is_refresh,
+        result_handler<Res> &&res_handler);
+    void save_result(K &&cache_key, const result<Res> &res);
+    void remove_entry(typename std::list<cache_entry>::iterator entry_iter);
+
+    event_loop &evloop;
+    caching_request_handler_config config;
+    std::shared_ptr<request_handler<Req, Res>> base_req_handler;
+    std::function<K(const Req &)> cache_key_func;
+    std::list<cache_entry> lru_entries;
+    std::map<K, typename std::list<cache_entry>::iterator> entries_by_key;
+    std::set<K> refreshed_keys;
+    caching_request_handler_stats stats;
+};
+
+
+template<typename Req, typename Res, typename K>
+lru_caching_request_handler<Req, Res, K>::lru_caching_request_handler(
+    event_loop &evloop, const caching_request_handler_config &config,
+    std::shared_ptr<request_handler<Req, Res>> &&base_req_handler,
+    std::function<K(const Req &)> &&cache_key_func)
+    : evloop(evloop), config(config), base_req_handler(std::move(base_req_handler)),
+    cache_key_func(std::move(cache_key_func)), lru_entries(), entries_by_key(), refreshed_keys(), stats{0, 0, 0}
+{
+}
+
+
+template<typename Req, typename Res, typename K>
+void lru_caching_request_handler<Req, Res, K>::handle_request(
+    Req &&request, std::chrono::nanoseconds timeout, result_handler<Res> &&res_handler)
+{
+    auto cache_key = cache_key_func(request);
+
+    auto entry_map_iter = entries_by_key.find(cache_key);
+    if (entry_map_iter != entries_by_key.end()) {
+        auto entry_iter = entry_map_iter->second;
+        const auto now = evloop.get_etime();
+        const auto fresh_end = std::get<std::chrono::time_point<eclock>>(*entry_iter);
+
+        if (now < fresh_end) {
+            ++stats.hits;
+            lru_entries.splice(lru_entries.begin(), lru_entries, entry_iter);
+            invoke_result_handler_later(evloop, std::move(res_handler), make_copy(std::get<result<Res>>(*entry_iter)));
+            return;
+        }
+
+        if (now < time_point_sat_add(fresh_end, config.stale_result_ttl)) {
+            ++stats.stale_hits;
+            lru_entries.splice(lru_entries.begin(), lru_entries, entry_iter);
+            invoke_result_handler_later(evloop, std::move(res_handler), make_copy(std::get<result<Res>>(*entry_iter)));
+            if (refreshed_keys.insert(cache_key).second) {
+                forward_request(std::move(cache_key), std::move(request), timeout, true, [](auto) {});
+            }
+            return;
+        }
+
+        remove_entry(entry_iter);
+    }
+
+    ++stats.misses;
+    forward_request(std::move(cache_key), std::move(request), timeout, false, std::move(res_handler));
+}
+
+
+template<typename Req, typename Res, typename K>
+caching_request_handler_stats lru_caching_request_handler<Req, Res, K>::get_stats() const
+{
+    return stats;
+}
+
+
+template<typename Req, typename Res, typename K>
+void lru_caching_request_handler<Req, Res, K>::forward_request(
+    K &&cache_key, Req &&request, std::chrono::nanoseconds timeout, bool is_refresh,
+    result_handler<Res> &&res_handler)
+{
+    base_req_handler->handle_request(
+        std::move(request), timeout,
+        [req_handler_wptr = weak_from_that(this), cache_key = std::move(cache_key), is_refresh, res_handler = std::move(res_handler)](auto res) mutable {
+            auto req_handler_ptr = req_handler_wptr.lock();
+            if (req_handler_ptr) {
+                if (is_refresh) {
+                    req_handler_ptr->refreshed_keys.erase(cache_key);
+                }
+                req_handler_ptr->save_result(std::move(cache_key), res);
+            }
+
+            res_handler(std::move(res));
+        });
+}
+
+
+template<typename Req, typename Res, typename K>
+void lru_caching_request_handler<Req, Res, K>::save_result(K &&cache_key, const result<Res> &res)
+{
+    std::chrono::nanoseconds ttl;
+    if (res.is_ok()) {
+        ttl = config.ok_result_ttl;
+    } else if (res.get_error() != std::make_error_code(std::errc::timed_out)) {
+        ttl = config.error_result_ttl;
+    } else {
+        return;
+    }
+
+    auto entry_map_iter = entries_by_key.find(cache_key);
+    if (entry_map_iter != entries_by_key.end()) {
+        remove_entry(entry_map_iter->second);
+    }
+
+    if (ttl <= std::chrono::nanoseconds(0) || config.max_entries == 0) {
+        return;
+    }
+
+    lru_entries.emplace_front(cache_key, res, time_point_sat_add(evloop.get_etime(), ttl));
+    entries_by_key.emplace(std::move(cache_key), lru_entries.begin());
+
+    if (lru_entries.size() > config.max_entries) {
+        remove_entry(std::prev(lru_entries.end()));
+    }
+}
+
+
+template<typename Req, typename Res, typename K>
+void lru_caching_request_handler<Req, Res, K>::remove_entry(typename std::list<cache_entry>::iterator entry_iter)
+{
+    entries_by_key.erase(std::get<0>(*entry_iter));
+    lru_entries.erase(entry_iter);
+}
+
+}
+
+
+template<typename Req, typename Res, typename K>
+std::shared_ptr<caching_request_handler<Req, Res>> make_caching_request_handler(
+    event_loop &evloop, const caching_request_handler_config &config,
+    std::shared_ptr<request_handler<Req, Res>> &&base_req_handler,
+    std::function<K(const Req &)> &&cache_key_func)
+{
+    return std::make_shared<caching_request_handler_impl::lru_caching_request_handler<Req, Res, K>>(
+        evloop, config, std::move(base_req_handler), std::move(cache_key_func));
+}
+
+}
+
+#endif /* NOSYNC__CACHING_REQUEST_HANDLER_IMPL_H */
@@ -0,0 +1,74 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#ifndef NOSYNC__CACHING_REQUEST_HANDLER_H
+#define NOSYNC__CACHING_REQUEST_HANDLER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <nosync/event-loop.h>
+#include <nosync/request-handler.h>
+
+
+namespace nosync
+{
+
+/*!
+Configuration of caching request_handler<> decorator.
+
+ - max_entries - maximum number of cached results, when exceeded then least
+recently used ones are removed,
+ - ok_result_ttl - time (in event loop time) for which successful results are
+considered fresh,
+ - error_result_ttl - the same for error results (timeout errors are never
+cached), zero disables caching of errors,
+ - stale_result_ttl - additional time after the result stops being fresh during
+which it's still returned, while the request is also forwarded to refresh it.
+*/
+struct caching_request_handler_config
+{
+    std::size_t max_entries;
+    std::chrono::nanoseconds ok_result_ttl;
+    std::chrono::nanoseconds error_result_ttl;
+    std::chrono::nanoseconds stale_result_ttl;
+};
+
+
+struct caching_request_handler_stats
+{
+    std::uint64_t hits;
+    std::uint64_t stale_hits;
+    std::uint64_t misses;
+};
+
+
+template<typename Req, typename Res>
+class caching_request_handler : public request_handler<Req, Res>
+{
+public:
+    virtual caching_request_handler_stats get_stats() const = 0;
+};
+
+
+/*!
+Create request_handler<> decorator which caches results of requests.
+
+Results are cached using keys returned by cache_key_func for requests, requests
+with equal keys are considered to be equivalent. Cached results are returned
+(asynchronously) without forwarding requests to the underlying request_handler.
+
+Concurrent requests missing the cache are all forwarded, for merging them use
+make_grouping_request_handler() as the underlying request_handler.
+*/
+template<typename Req, typename Res, typename K>
+std::shared_ptr<caching_request_handler<Req, Res>> make_caching_request_handler(
+    event_loop &evloop, const caching_request_handler_config &config,
+    std::shared_ptr<request_handler<Req, Res>> &&base_req_handler,
+    std::function<K(const Req &)> &&cache_key_func);
+
+}
+
+#include <nosync/caching-request-handler-impl.h>
+
+#endif /* NOSYNC__CACHING_REQUEST_HANDLER_H */
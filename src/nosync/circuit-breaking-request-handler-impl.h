@@ -0,0 +1,189 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#ifndef NOSYNC__CIRCUIT_BREAKING_REQUEST_HANDLER_IMPL_H
+#define NOSYNC__CIRCUIT_BREAKING_REQUEST_HANDLER_IMPL_H
+
+#include <deque>
+#include <nosync/eclock.h>
+#include <nosync/memory-utils.h>
+#include <nosync/raw-error-result.h>
+#include <nosync/result-handler-utils.h>
+#include <nosync/time-utils.h>
+#include <stdexcept>
+#include <system_error>
+#include <tuple>
+#include <utility>
+
+
+namespace nosync
+{
+
+namespace circuit_breaking_request_handler_impl
+{
+
+enum class circuit_state
+{
+    closed,
+    open,
+    half_open,
+};
+
+
+template<typename Req, typename Res>
+class circuit_breaking_request_handler : public request_handler<Req, Res>, public std::enable_shared_from_this<circuit_breaking_request_handler<Req, Res>>
+{
+public:
+    circuit_breaking_request_handler(
+        event_loop &evloop, const circuit_breaker_config &config,
+        std::shared_ptr<request_handler<Req, Res>> &&base_req_handler);
+
+    void handle_request(Req &&request, std::chrono::nanoseconds timeout, result_handler<Res> &&res_handler) override;
+
+private:
+    void handle_result(bool is_probe, bool is_error);
+    void save_result(bool is_error);
+    void drop_outdated_results();
+    void open_circuit();
+    void close_circuit();
+
+    event_loop &evloop;
+    circuit_breaker_config config;
+    std::shared_ptr<request_handler<Req, Res>> base_req_handler;
+    circuit_state state;
+    std::chrono::time_point<eclock> open_end;
+    bool probe_ongoing;
+    std::deque<std::tuple<std::chrono::time_point<eclock>, bool>> window_results;
+    std::size_t window_errors_count;
+};
+
+
+template<typename Req, typename Res>
+circuit_breaking_request_handler<Req, Res>::circuit_breaking_request_handler(
+    event_loop &evloop, const circuit_breaker_config &config,
+    std::shared_ptr<request_handler<Req, Res>> &&base_req_handler)
+    : evloop(evloop), config(config), base_req_handler(std::move(base_req_handler)), state(circuit_state::closed),
+    open_end(), probe_ongoing(false), window_results(), window_errors_count(0)
+{
+}
+
+
+template<typename Req, typename Res>
+void circuit_breaking_request_handler<Req, Res>::handle_request(
+    Req &&request, std::chrono::nanoseconds timeout, result_handler<Res> &&res_handler)
+{
+    if (state == circuit_state::open && evloop.get_etime() >= open_end) {
+        state = circuit_state::half_open;
+    }
+
+    if (state == circuit_state::open || (state == circuit_state::half_open && probe_ongoing)) {
+        invoke_result_handler_later(
+            evloop, std::move(res_handler), raw_error_result(std::errc::device_or_resource_busy));
+        return;
+    }
+
+    const bool is_probe = state == circuit_state::half_open;
+    if (is_probe) {
+        probe_ongoing = true;
+    }
+
+    base_req_handler->handle_request(
+        std::move(request), timeout,
+        [req_handler_wptr = weak_from_that(this), is_probe, res_handler = std::move(res_handler)](auto res) {
+            auto req_handler_ptr = req_handler_wptr.lock();
+            if (req_handler_ptr) {
+                req_handler_ptr->handle_result(is_probe, !res.is_ok());
+            }
+
+            res_handler(std::move(res));
+        });
+}
+
+
+template<typename Req, typename Res>
+void circuit_breaking_request_handler<Req, Res>::handle_result(bool is_probe, bool is_error)
+{
+    if (is_probe) {
+        probe_ongoing = false;
+        if (is_error) {
+            open_circuit();
+        } else {
+            close_circuit();
+        }
+    } else if (state == circuit_state::closed) {
+        save_result(is_error);
+    }
+}
+
+
+template<typename Req, typename Res>
+void circuit_breaking_request_handler<Req, Res>::save_result(bool is_error)
+{
+    window_results.emplace_back(evloop.get_etime(), is_error);
+    if (is_error) {
+        ++window_errors_count;
+    }
+
+    drop_outdated_results();
+
+    if (window_results.size() >= config.min_requests_count
+        && window_errors_count >= config.error_rate_threshold * window_results.size()) {
+        open_circuit();
+    }
+}
+
+
+template<typename Req, typename Res>
+void circuit_breaking_request_handler<Req, Res>::drop_outdated_results()
+{
+    const auto window_start = evloop.get_etime() - config.window;
+
+    while (!window_results.empty() && std::get<std::chrono::time_point<eclock>>(window_results.front()) <= window_start) {
+        if (std::get<bool>(window_results.front())) {
+            --window_errors_count;
+        }
+        window_results.pop_front();
+    }
+}
+
+
+template<typename Req, typename Res>
+void circuit_breaking_request_handler<Req, Res>::open_circuit()
+{
+    state = circuit_state::open;
+    open_end = time_point_sat_add(evloop.get_etime(), config.open_duration);
+    window_results.clear();
+    window_errors_count = 0;
+}
+
+
+template<typename Req, typename Res>
+void circuit_breaking_request_handler<Req, Res>::close_circuit()
+{
+    state = circuit_state::closed;
+    window_results.clear();
+    window_errors_count = 0;
+}
+
+}
+
+
+template<typename Req, typename Res>
+std::shared_ptr<request_handler<Req, Res>> make_circuit_breaking_request_handler(
+    event_loop &evloop, const circuit_breaker_config &config,
+    std::shared_ptr<request_handler<Req, Res>> &&base_req_handler)
+{
+    if (!(config.error_rate_threshold > 0 && config.error_rate_threshold <= 1)) {
+        throw std::invalid_argument("circuit breaker error rate threshold must be in (0, 1] range");
+    }
+
+    if (config.min_requests_count == 0 || config.window <= std::chrono::nanoseconds::zero()
+        || config.open_duration <= std::chrono::nanoseconds::zero()) {
+        throw std::invalid_argument("circuit breaker min requests count, window and open duration must be positive");
+    }
+
+    return std::make_shared<circuit_breaking_request_handler_impl::circuit_breaking_request_handler<Req, Res>>(
+        evloop, config, std::move(base_req_handler));
+}
+
+}
+
+#endif /* NOSYNC__CIRCUIT_BREAKING_REQUEST_HANDLER_IMPL_H */
@@ -0,0 +1,56 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#ifndef NOSYNC__CIRCUIT_BREAKING_REQUEST_HANDLER_H
+#define NOSYNC__CIRCUIT_BREAKING_REQUEST_HANDLER_H
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <nosync/event-loop.h>
+#include <nosync/request-handler.h>
+
+
+namespace nosync
+{
+
+/*!
+Configuration of circuit breaking request_handler<> decorator.
+
+ - window - length (in event loop time) of sliding window of results used
+for calculating error rate,
+ - min_requests_count - minimal number of results in the window needed for
+opening the circuit,
+ - error_rate_threshold - error rate (in range (0, 1]) at which the circuit
+is opened,
+ - open_duration - time for which the circuit stays open before probing.
+*/
+struct circuit_breaker_config
+{
+    std::chrono::nanoseconds window;
+    std::size_t min_requests_count;
+    double error_rate_threshold;
+    std::chrono::nanoseconds open_duration;
+};
+
+
+/*!
+Create request_handler<> decorator which stops forwarding requests to failing request_handler.
+
+Results (both successes and errors, including timeouts) of forwarded requests
+are tracked over sliding window. When error rate in the window reaches the
+threshold (with at least min_requests_count results), the circuit gets open and
+all requests fail fast (asynchronously) with std::errc::device_or_resource_busy
+error for open_duration. After that time the circuit becomes half-open - single
+probe request is forwarded (the others still fail fast), its success closes the
+circuit (with the window cleared), its failure opens the circuit again. Invalid
+configuration is reported with std::invalid_argument exception.
+*/
+template<typename Req, typename Res>
+std::shared_ptr<request_handler<Req, Res>> make_circuit_breaking_request_handler(
+    event_loop &evloop, const circuit_breaker_config &config,
+    std::shared_ptr<request_handler<Req, Res>> &&base_req_handler);
+
+}
+
+#include <nosync/circuit-breaking-request-handler-impl.h>
+
+#endif /* NOSYNC__CIRCUIT_BREAKING_REQUEST_HANDLER_H */
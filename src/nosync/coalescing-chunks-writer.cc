@@ -0,0 +1,103 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#include <nosync/coalescing-chunks-writer.h>
+#include <nosync/event-loop-utils.h>
+#include <nosync/memory-utils.h>
+#include <nosync/requests-queue.h>
+#include <nosync/time-utils.h>
+#include <vector>
+
+namespace ch = std::chrono;
+using std::enable_shared_from_this;
+using std::get;
+using std::make_shared;
+using std::move;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+
+namespace nosync
+{
+
+namespace
+{
+
+class coalescing_chunks_writer : public request_handler<string, void>, public enable_shared_from_this<coalescing_chunks_writer>
+{
+public:
+    coalescing_chunks_writer(event_loop &evloop, shared_ptr<bytes_writer> &&base_writer);
+
+    void handle_request(string &&data, ch::nanoseconds timeout, result_handler<void> &&res_handler) override;
+
+private:
+    void write_pending_chunks();
+
+    event_loop &evloop;
+    shared_ptr<bytes_writer> base_writer;
+    requests_queue<string, void> pending_chunks;
+    bool write_ongoing;
+};
+
+
+coalescing_chunks_writer::coalescing_chunks_writer(event_loop &evloop, shared_ptr<bytes_writer> &&base_writer)
+    : evloop(evloop), base_writer(move(base_writer)), pending_chunks(evloop), write_ongoing(false)
+{
+}
+
+
+void coalescing_chunks_writer::handle_request(string &&data, ch::nanoseconds timeout, result_handler<void> &&res_handler)
+{
+    pending_chunks.push_request(move(data), time_point_sat_add(evloop.get_etime(), timeout), move(res_handler));
+
+    if (!write_ongoing) {
+        invoke_later(
+            evloop,
+            make_weak_this_func_proxy(
+                this,
+                [](auto &self) {
+                    self.write_pending_chunks();
+                }));
+        write_ongoing = true;
+    }
+}
+
+
+void coalescing_chunks_writer::write_pending_chunks()
+{
+    if (!pending_chunks.has_requests()) {
+        write_ongoing = false;
+        return;
+    }
+
+    string data;
+    vector<result_handler<void>> res_handlers;
+    while (pending_chunks.has_requests()) {
+        auto chunk = pending_chunks.pull_next_request();
+        data.append(get<string>(chunk));
+        res_handlers.push_back(move(get<result_handler<void>>(chunk)));
+    }
+
+    base_writer->write_bytes(
+        move(data),
+        [writer_wptr = weak_from_that(this), res_handlers = move(res_handlers)](auto res) {
+            for (auto &res_handler : res_handlers) {
+                res_handler(res);
+            }
+
+            auto writer_ptr = writer_wptr.lock();
+            if (writer_ptr) {
+                writer_ptr->write_pending_chunks();
+            }
+        });
+}
+
+}
+
+
+shared_ptr<request_handler<string, void>> make_coalescing_chunks_writer(
+    event_loop &evloop, shared_ptr<bytes_writer> &&base_writer)
+{
+    return make_shared<coalescing_chunks_writer>(evloop, move(base_writer));
+}
+
+}
@@ -0,0 +1,30 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#ifndef NOSYNC__COALESCING_CHUNKS_WRITER_H
+#define NOSYNC__COALESCING_CHUNKS_WRITER_H
+
+#include <nosync/event-loop.h>
+#include <nosync/bytes-writer.h>
+#include <nosync/request-handler.h>
+#include <memory>
+#include <string>
+
+
+namespace nosync
+{
+
+/*!
+Create chunks writer which merges chunks queued in the meantime into single writes.
+
+Like make_sequential_chunks_writer(), the returned object writes chunks in the
+order of receipt, one write at a time. However, all chunks received within
+single event loop iteration (or while previous write is ongoing) are
+concatenated and passed to the underlying writer with single write_bytes()
+call. The result of such write is reported separately to each chunk's result
+handler.
+*/
+std::shared_ptr<request_handler<std::string, void>> make_coalescing_chunks_writer(
+    event_loop &evloop, std::shared_ptr<bytes_writer> &&base_writer);
+
+}
+
+#endif /* NOSYNC__COALESCING_CHUNKS_WRITER_H */
@@ -0,0 +1,127 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#ifndef NOSYNC__CONCURRENCY_LIMITED_REQUEST_HANDLER_IMPL_H
+#define NOSYNC__CONCURRENCY_LIMITED_REQUEST_HANDLER_IMPL_H
+
+#include <algorithm>
+#include <nosync/memory-utils.h>
+#include <nosync/requests-queue.h>
+#include <nosync/time-utils.h>
+#include <stdexcept>
+#include <utility>
+
+
+namespace nosync
+{
+
+namespace concurrency_limited_request_handler_impl
+{
+
+template<typename Req, typename Res>
+class concurrency_limited_request_handler : public request_handler<Req, Res>, public std::enable_shared_from_this<concurrency_limited_request_handler<Req, Res>>
+{
+public:
+    concurrency_limited_request_handler(
+        event_loop &evloop, std::size_t max_in_flight, std::shared_ptr<request_handler<Req, Res>> &&base_req_handler);
+    concurrency_limited_request_handler(
+        event_loop &evloop, std::size_t max_in_flight, const requests_queue_capacity &pending_requests_capacity,
+        std::shared_ptr<request_handler<Req, Res>> &&base_req_handler);
+
+    void handle_request(Req &&request, std::chrono::nanoseconds timeout, result_handler<Res> &&res_handler) override;
+
+    void set_max_in_flight(std::size_t new_max_in_flight);
+
+private:
+    void handle_next_pending_request_if_needed();
+
+    event_loop &evloop;
+    std::size_t max_in_flight;
+    std::shared_ptr<request_handler<Req, Res>> base_req_handler;
+    requests_queue<Req, Res> pending_requests;
+    std::size_t ongoing_requests_count;
+};
+
+
+template<typename Req, typename Res>
+concurrency_limited_request_handler<Req, Res>::concurrency_limited_request_handler(
+    event_loop &evloop, std::size_t max_in_flight, std::shared_ptr<request_handler<Req, Res>> &&base_req_handler)
+    : concurrency_limited_request_handler(
+        evloop, max_in_flight, make_unlimited_requests_queue_capacity(), std::move(base_req_handler))
+{
+}
+
+
+template<typename Req, typename Res>
+concurrency_limited_request_handler<Req, Res>::concurrency_limited_request_handler(
+    event_loop &evloop, std::size_t max_in_flight, const requests_queue_capacity &pending_requests_capacity,
+    std::shared_ptr<request_handler<Req, Res>> &&base_req_handler)
+    : evloop(evloop), max_in_flight(max_in_flight), base_req_handler(std::move(base_req_handler)),
+    pending_requests(evloop, pending_requests_capacity), ongoing_requests_count(0)
+{
+}
+
+
+template<typename Req, typename Res>
+void concurrency_limited_request_handler<Req, Res>::handle_request(
+    Req &&request, std::chrono::nanoseconds timeout, result_handler<Res> &&res_handler)
+{
+    if (ongoing_requests_count < max_in_flight) {
+        ++ongoing_requests_count;
+        base_req_handler->handle_request(
+            std::move(request), timeout,
+            [req_handler_wptr = weak_from_that(this), res_handler = std::move(res_handler)](auto res) {
+                res_handler(std::move(res));
+                auto req_handler_ptr = req_handler_wptr.lock();
+                if (req_handler_ptr) {
+                    --req_handler_ptr->ongoing_requests_count;
+                    req_handler_ptr->handle_next_pending_request_if_needed();
+                }
+            });
+    } else {
+        pending_requests.push_request(
+            std::move(request), time_point_sat_add(evloop.get_etime(), timeout), std::move(res_handler));
+    }
+}
+
+
+template<typename Req, typename Res>
+void concurrency_limited_request_handler<Req, Res>::set_max_in_flight(std::size_t new_max_in_flight)
+{
+    if (new_max_in_flight == 0) {
+        throw std::invalid_argument("max in flight requests count must be positive");
+    }
+
+    max_in_flight = new_max_in_flight;
+}
+
+
+template<typename Req, typename Res>
+void concurrency_limited_request_handler<Req, Res>::handle_next_pending_request_if_needed()
+{
+    while (pending_requests.has_requests() && ongoing_requests_count < max_in_flight) {
+        auto req_pack = pending_requests.pull_next_request();
+
+        handle_request(
+            std::move(std::get<0>(req_pack)),
+            std::max(std::get<1>(req_pack) - evloop.get_etime(), std::chrono::nanoseconds(0)),
+            std::move(std::get<2>(req_pack)));
+    }
+}
+
+}
+
+
+template<typename Req, typename Res>
+std::shared_ptr<request_handler<Req, Res>> make_concurrency_limited_request_handler(
+    event_loop &evloop, std::size_t max_in_flight, std::shared_ptr<request_handler<Req, Res>> &&base_req_handler)
+{
+    if (max_in_flight == 0) {
+        throw std::invalid_argument("max in flight requests count must be positive");
+    }
+
+    return std::make_shared<concurrency_limited_request_handler_impl::concurrency_limited_request_handler<Req, Res>>(
+        evloop, max_in_flight, std::move(base_req_handler));
+}
+
+}
+
+#endif /* NOSYNC__CONCURRENCY_LIMITED_REQUEST_HANDLER_IMPL_H */
@@ -0,0 +1,31 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#ifndef NOSYNC__CONCURRENCY_LIMITED_REQUEST_HANDLER_H
+#define NOSYNC__CONCURRENCY_LIMITED_REQUEST_HANDLER_H
+
+#include <cstddef>
+#include <memory>
+#include <nosync/event-loop.h>
+#include <nosync/request-handler.h>
+
+
+namespace nosync
+{
+
+/*!
+Create request_handler<> decorator which limits the number of concurrently handled requests.
+
+Up to max_in_flight requests are forwarded to the underlying request_handler at
+a time, the rest of them wait in a queue (in the order of receipt) until one of
+the ongoing requests finishes. make_sequential_request_handler() is equivalent
+to this decorator with max_in_flight equal to 1. Zero max_in_flight is reported
+with std::invalid_argument exception.
+*/
+template<typename Req, typename Res>
+std::shared_ptr<request_handler<Req, Res>> make_concurrency_limited_request_handler(
+    event_loop &evloop, std::size_t max_in_flight, std::shared_ptr<request_handler<Req, Res>> &&base_req_handler);
+
+}
+
+#include <nosync/concurrency-limited-request-handler-impl.h>
+
+#endif /* NOSYNC__CONCURRENCY_LIMITED_REQUEST_HANDLER_H */
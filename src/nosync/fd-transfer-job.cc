@@ -0,0 +1,206 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#include <algorithm>
+#include <cerrno>
+#include <limits>
+#include <nosync/event-loop-utils.h>
+#include <nosync/fd-transfer-job.h>
+#include <nosync/fd-utils.h>
+#include <nosync/memory-utils.h>
+#include <nosync/raw-error-result.h>
+#include <nosync/result-handler-utils.h>
+#include <nosync/result-utils.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <system_error>
+#include <utility>
+
+namespace ch = std::chrono;
+using std::enable_shared_from_this;
+using std::errc;
+using std::make_error_code;
+using std::make_shared;
+using std::move;
+using std::numeric_limits;
+using std::size_t;
+using std::uint64_t;
+using std::unique_ptr;
+
+
+namespace nosync
+{
+
+namespace
+{
+
+constexpr size_t max_transfer_chunk_size = 0x7ffff000U;
+
+
+class fd_transfer_job : public enable_shared_from_this<fd_transfer_job>
+{
+public:
+    static void start(
+        fd_watching_event_loop &evloop, shared_fd &&src_fd, shared_fd &&dst_fd,
+        uint64_t offset, size_t length, ch::nanoseconds timeout, result_handler<size_t> &&res_handler);
+
+    fd_transfer_job(
+        fd_watching_event_loop &evloop, shared_fd &&src_fd, shared_fd &&dst_fd, bool src_is_pipe,
+        ::off_t offset, size_t length, result_handler<size_t> &&res_handler);
+
+private:
+    void schedule_timeout(ch::nanoseconds timeout);
+    void watch_fd(int fd, fd_watch_mode mode);
+    void handle_transfer_chunk();
+    result<size_t> transfer_some_bytes();
+    bool is_src_pipe_readable() const;
+    void finish(result<size_t> &&res);
+
+    fd_watching_event_loop &evloop;
+    shared_fd src_fd;
+    shared_fd dst_fd;
+    bool src_is_pipe;
+    ::off_t offset;
+    size_t length;
+    size_t transferred_size;
+    result_handler<size_t> res_handler;
+    int watched_fd;
+    unique_ptr<activity_handle> watch_handle;
+    unique_ptr<activity_handle> timeout_task_handle;
+};
+
+
+void fd_transfer_job::start(
+    fd_watching_event_loop &evloop, shared_fd &&src_fd, shared_fd &&dst_fd,
+    uint64_t offset, size_t length, ch::nanoseconds timeout, result_handler<size_t> &&res_handler)
+{
+    struct ::stat src_stat;
+    if (::fstat(*src_fd, &src_stat) != 0) {
+        invoke_result_handler_later(evloop, move(res_handler), make_raw_error_result_from_errno());
+        return;
+    }
+
+    const bool src_is_pipe = S_ISFIFO(src_stat.st_mode);
+    if ((src_is_pipe && offset != 0) || offset > static_cast<uint64_t>(numeric_limits<::off_t>::max())) {
+        invoke_result_handler_later(evloop, move(res_handler), raw_error_result(errc::invalid_argument));
+        return;
+    }
+
+    if (length == 0) {
+        invoke_result_handler_later(evloop, move(res_handler), make_ok_result(size_t(0)));
+        return;
+    }
+
+    auto dst_fd_num = *dst_fd;
+    auto job = make_shared<fd_transfer_job>(
+        evloop, move(src_fd), move(dst_fd), src_is_pipe, static_cast<::off_t>(offset), length, move(res_handler));
+    job->schedule_timeout(timeout);
+    job->watch_fd(dst_fd_num, fd_watch_mode::output);
+}
+
+
+fd_transfer_job::fd_transfer_job(
+    fd_watching_event_loop &evloop, shared_fd &&src_fd, shared_fd &&dst_fd, bool src_is_pipe,
+    ::off_t offset, size_t length, result_handler<size_t> &&res_handler)
+    : evloop(evloop), src_fd(move(src_fd)), dst_fd(move(dst_fd)), src_is_pipe(src_is_pipe),
+    offset(offset), length(length), transferred_size(0U), res_handler(move(res_handler)),
+    watched_fd(-1), watch_handle(), timeout_task_handle()
+{
+}
+
+
+void fd_transfer_job::schedule_timeout(ch::nanoseconds timeout)
+{
+    timeout_task_handle = invoke_with_etime_delay(
+        evloop, timeout,
+        [job_wptr = weak_from_that(this)]() {
+            auto job_ptr = job_wptr.lock();
+            if (job_ptr) {
+                job_ptr->finish(make_timeout_raw_error_result());
+            }
+        });
+}
+
+
+void fd_transfer_job::watch_fd(int fd, fd_watch_mode mode)
+{
+    if (fd == watched_fd) {
+        return;
+    }
+
+    if (watch_handle && watch_handle->is_enabled()) {
+        watch_handle->disable();
+    }
+
+    watched_fd = fd;
+    watch_handle = evloop.add_watch(
+        fd, mode,
+        [job = shared_from_this()]() {
+            job->handle_transfer_chunk();
+        });
+}
+
+
+void fd_transfer_job::handle_transfer_chunk()
+{
+    auto transfer_res = transfer_some_bytes();
+    if (transfer_res.is_ok()) {
+        transferred_size += transfer_res.get_value();
+        if (transfer_res.get_value() == 0 || transferred_size >= length) {
+            finish(make_ok_result(transferred_size));
+        } else {
+            watch_fd(*dst_fd, fd_watch_mode::output);
+        }
+    } else if (transfer_res.get_error() == make_error_code(errc::resource_unavailable_try_again)) {
+        if (src_is_pipe && !is_src_pipe_readable()) {
+            watch_fd(*src_fd, fd_watch_mode::input);
+        } else {
+            watch_fd(*dst_fd, fd_watch_mode::output);
+        }
+    } else {
+        finish(raw_error_result(transfer_res));
+    }
+}
+
+
+result<size_t> fd_transfer_job::transfer_some_bytes()
+{
+    const auto chunk_size = std::min(length - transferred_size, max_transfer_chunk_size);
+    return src_is_pipe
+        ? splice_some_bytes_between_fds(*src_fd, *dst_fd, chunk_size)
+        : send_some_file_bytes_to_fd(*dst_fd, *src_fd, offset, chunk_size);
+}
+
+
+bool fd_transfer_job::is_src_pipe_readable() const
+{
+    ::pollfd src_pollfd = {*src_fd, POLLIN, 0};
+    return ::poll(&src_pollfd, 1, 0) > 0;
+}
+
+
+void fd_transfer_job::finish(result<size_t> &&res)
+{
+    if (watch_handle->is_enabled()) {
+        watch_handle->disable();
+    }
+
+    if (timeout_task_handle->is_enabled()) {
+        timeout_task_handle->disable();
+    }
+
+    auto tmp_res_handler = move(res_handler);
+    res_handler = nullptr;
+    tmp_res_handler(move(res));
+}
+
+}
+
+
+void start_fd_transfer_job(
+    fd_watching_event_loop &evloop, shared_fd &&src_fd, shared_fd &&dst_fd,
+    uint64_t offset, size_t length, ch::nanoseconds timeout, result_handler<size_t> &&res_handler)
+{
+    fd_transfer_job::start(evloop, move(src_fd), move(dst_fd), offset, length, timeout, move(res_handler));
+}
+
+}
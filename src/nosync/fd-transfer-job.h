@@ -0,0 +1,40 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#ifndef NOSYNC__FD_TRANSFER_JOB_H
+#define NOSYNC__FD_TRANSFER_JOB_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <nosync/fd-watching-event-loop.h>
+#include <nosync/result-handler.h>
+#include <nosync/shared-fd.h>
+
+
+namespace nosync
+{
+
+/*!
+Start asynchronous in-kernel transfer of bytes between file descriptors.
+
+The job copies up to length bytes from src_fd to (non-blocking) dst_fd without
+passing them through user space buffers. If src_fd is a pipe, data is moved
+with splice() (offset must be zero in such case), otherwise it is sent with
+sendfile() starting at given offset (the file position of src_fd is not
+changed). The job waits for dst_fd (or src_fd in case of empty pipe) readiness
+using fd watches of the event loop.
+
+Result handler is called with the number of transferred bytes when all of them
+were transferred or end of src_fd was reached, or with error of the first
+failed transfer operation. If the job doesn't finish within timeout, it's
+stopped and the handler gets timeout error (the number of bytes transferred
+until then isn't reported). The job can't be cancelled otherwise, it keeps
+both file descriptors open until it finishes.
+*/
+void start_fd_transfer_job(
+    fd_watching_event_loop &evloop, shared_fd &&src_fd, shared_fd &&dst_fd,
+    std::uint64_t offset, std::size_t length, std::chrono::nanoseconds timeout,
+    result_handler<std::size_t> &&res_handler);
+
+}
+
+#endif /* NOSYNC__FD_TRANSFER_JOB_H */
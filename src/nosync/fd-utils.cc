@@ -2,9 +2,11 @@
 #include <array>
 #include <cerrno>
 #include <cstddef>
+#include <fcntl.h>
 #include <memory>
 #include <nosync/fd-utils.h>
 #include <nosync/result-utils.h>
+#include <sys/sendfile.h>
 #include <system_error>
 #include <unistd.h>
 
@@ -67,4 +69,36 @@ result<size_t> write_some_bytes_to_fd(int fd, string_view data)
     return res;
 }
 
+
+result<size_t> send_some_file_bytes_to_fd(int out_fd, int in_fd, ::off_t &offset, size_t max_size)
+{
+    ssize_t sendfile_res;
+    do {
+        sendfile_res = ::sendfile(out_fd, in_fd, &offset, max_size);
+    } while (sendfile_res == -1 && errno == EINTR);
+
+    auto res =
+        sendfile_res >= 0
+            ? make_ok_result(static_cast<size_t>(sendfile_res))
+            : make_raw_error_result_from_errno();
+
+    return res;
+}
+
+
+result<size_t> splice_some_bytes_between_fds(int in_fd, int out_fd, size_t max_size)
+{
+    ssize_t splice_res;
+    do {
+        splice_res = ::splice(in_fd, nullptr, out_fd, nullptr, max_size, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+    } while (splice_res == -1 && errno == EINTR);
+
+    auto res =
+        splice_res >= 0
+            ? make_ok_result(static_cast<size_t>(splice_res))
+            : make_raw_error_result_from_errno();
+
+    return res;
+}
+
 }
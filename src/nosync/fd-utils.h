@@ -6,6 +6,7 @@
 #include <experimental/string_view>
 #include <nosync/result.h>
 #include <string>
+#include <sys/types.h>
 
 
 namespace nosync
@@ -26,6 +27,27 @@ The function automatically handles EINTR from system call (by retrying it).
 */
 result<std::size_t> write_some_bytes_to_fd(int fd, std::experimental::string_view data);
 
+
+/*!
+Wrapper around Linux sendfile() that returns status as result<>.
+
+Copies (in kernel) up to max_size bytes from in_fd (which must support mmap,
+e.g. regular file), starting at given offset (which is advanced by the number of
+bytes copied), to out_fd. The function automatically handles EINTR from system
+call (by retrying it).
+*/
+result<std::size_t> send_some_file_bytes_to_fd(int out_fd, int in_fd, ::off_t &offset, std::size_t max_size);
+
+
+/*!
+Wrapper around Linux splice() that returns status as result<>.
+
+Moves (in kernel, without blocking) up to max_size bytes from in_fd to out_fd,
+one of which must be a pipe. The function automatically handles EINTR from
+system call (by retrying it).
+*/
+result<std::size_t> splice_some_bytes_between_fds(int in_fd, int out_fd, std::size_t max_size);
+
 }
 
 #endif /* NOSYNC__FD_UTILS_H */
@@ -15,6 +15,7 @@ enum class fd_watch_mode
 {
     input,
     output,
+    error,
 };
 
 
@@ -23,7 +24,9 @@ Interface for monitoring states of file descriptors.
 
 This interface can be used for monitoring file descriptors and triggering
 notifications when they are ready to read data from or write data to (depending
-on "watch mode" used when adding new watch).
+on "watch mode" used when adding new watch). Watches in error mode are notified
+only about error condition of the file descriptor (e.g. non-empty error queue
+or pending error of a socket), not about its input or output readiness.
 
 Any number of watches can be registered for the same file descriptor (both with
 the same and with different watch modes).
@@ -0,0 +1,104 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#ifndef NOSYNC__GROUPING_REQUEST_HANDLER_IMPL_H
+#define NOSYNC__GROUPING_REQUEST_HANDLER_IMPL_H
+
+#include <map>
+#include <nosync/memory-utils.h>
+#include <nosync/requests-queue.h>
+#include <nosync/result-handler.h>
+#include <nosync/time-utils.h>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+
+namespace nosync
+{
+
+namespace grouping_request_handler_impl
+{
+
+template<typename Req, typename Res, typename K>
+class grouping_request_handler : public request_handler<Req, Res>, public std::enable_shared_from_this<grouping_request_handler<Req, Res, K>>
+{
+public:
+    grouping_request_handler(
+        event_loop &evloop, std::shared_ptr<request_handler<Req, Res>> &&base_req_handler,
+        std::function<K(const Req &)> &&group_key_func);
+
+    void handle_request(Req &&request, std::chrono::nanoseconds timeout, result_handler<Res> &&res_handler) override;
+
+private:
+    event_loop &evloop;
+    std::shared_ptr<request_handler<Req, Res>> base_req_handler;
+    std::function<K(const Req &)> group_key_func;
+    std::map<K, std::unique_ptr<requests_queue<Req, Res>>> ongoing_groups;
+};
+
+
+template<typename Req, typename Res, typename K>
+grouping_request_handler<Req, Res, K>::grouping_request_handler(
+    event_loop &evloop, std::shared_ptr<request_handler<Req, Res>> &&base_req_handler,
+    std::function<K(const Req &)> &&group_key_func)
+    : evloop(evloop), base_req_handler(std::move(base_req_handler)), group_key_func(std::move(group_key_func)),
+    ongoing_groups()
+{
+}
+
+
+template<typename Req, typename Res, typename K>
+void grouping_request_handler<Req, Res, K>::handle_request(
+    Req &&request, std::chrono::nanoseconds timeout, result_handler<Res> &&res_handler)
+{
+    auto group_key = group_key_func(request);
+
+    auto group_iter = ongoing_groups.find(group_key);
+    if (group_iter != ongoing_groups.end()) {
+        group_iter->second->push_request(
+            std::move(request), time_point_sat_add(evloop.get_etime(), timeout), std::move(res_handler));
+        return;
+    }
+
+    ongoing_groups.emplace(group_key, std::make_unique<requests_queue<Req, Res>>(evloop));
+
+    base_req_handler->handle_request(
+        std::move(request), timeout,
+        [req_handler_wptr = weak_from_that(this), group_key = std::move(group_key), res_handler = std::move(res_handler)](auto res) mutable {
+            std::vector<std::tuple<Req, std::chrono::time_point<eclock>, result_handler<Res>>> grouped_reqs;
+
+            auto req_handler_ptr = req_handler_wptr.lock();
+            if (req_handler_ptr) {
+                auto group_iter = req_handler_ptr->ongoing_groups.find(group_key);
+                auto &group_reqs = *group_iter->second;
+                while (group_reqs.has_requests()) {
+                    grouped_reqs.push_back(group_reqs.pull_next_request());
+                }
+                req_handler_ptr->ongoing_groups.erase(group_iter);
+            }
+
+            res_handler(res);
+            res_handler = nullptr;
+
+            for (auto &req : grouped_reqs) {
+                auto &pending_res_handler = std::get<result_handler<Res>>(req);
+                pending_res_handler(res);
+                pending_res_handler = nullptr;
+            }
+        });
+}
+
+}
+
+
+template<typename Req, typename Res, typename K>
+std::shared_ptr<request_handler<Req, Res>> make_grouping_request_handler(
+    event_loop &evloop, std::shared_ptr<request_handler<Req, Res>> &&base_req_handler,
+    std::function<K(const Req &)> &&group_key_func)
+{
+    return std::make_shared<grouping_request_handler_impl::grouping_request_handler<Req, Res, K>>(
+        evloop, std::move(base_req_handler), std::move(group_key_func));
+}
+
+}
+
+#endif /* NOSYNC__GROUPING_REQUEST_HANDLER_IMPL_H */
@@ -0,0 +1,33 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#ifndef NOSYNC__GROUPING_REQUEST_HANDLER_H
+#define NOSYNC__GROUPING_REQUEST_HANDLER_H
+
+#include <functional>
+#include <memory>
+#include <nosync/event-loop.h>
+#include <nosync/request-handler.h>
+
+
+namespace nosync
+{
+
+/*!
+Create request_handler<> decorator for satisfying groups of concurrent requests with equal keys with copies of single result.
+
+Generalized version of make_grouping_null_request_handler(). Request for which
+no request with the same key (as returned by group_key_func) is ongoing is
+forwarded to the underlying request_handler. Requests with the same key received
+while it's ongoing are not forwarded, instead they wait (each with its own
+timeout) for the result of the ongoing request, which is then passed to all of
+them.
+*/
+template<typename Req, typename Res, typename K>
+std::shared_ptr<request_handler<Req, Res>> make_grouping_request_handler(
+    event_loop &evloop, std::shared_ptr<request_handler<Req, Res>> &&base_req_handler,
+    std::function<K(const Req &)> &&group_key_func);
+
+}
+
+#include <nosync/grouping-request-handler-impl.h>
+
+#endif /* NOSYNC__GROUPING_REQUEST_HANDLER_H */
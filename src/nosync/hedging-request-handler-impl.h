@@ -0,0 +1,200 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#ifndef NOSYNC__HEDGING_REQUEST_HANDLER_IMPL_H
+#define NOSYNC__HEDGING_REQUEST_HANDLER_IMPL_H
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <experimental/optional>
+#include <nosync/activity-handle.h>
+#include <nosync/eclock.h>
+#include <nosync/memory-utils.h>
+#include <nosync/time-utils.h>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+namespace nosync
+{
+
+namespace hedging_request_handler_impl
+{
+
+template<typename Res>
+struct hedged_request_context
+{
+    explicit hedged_request_context(result_handler<Res> &&res_handler);
+
+    void call_res_handler_once(result<Res> &&res);
+
+    result_handler<Res> res_handler;
+    std::unique_ptr<activity_handle> hedge_task_handle;
+};
+
+
+template<typename Res>
+hedged_request_context<Res>::hedged_request_context(result_handler<Res> &&res_handler)
+    : res_handler(std::move(res_handler)), hedge_task_handle()
+{
+}
+
+
+template<typename Res>
+void hedged_request_context<Res>::call_res_handler_once(result<Res> &&res)
+{
+    if (hedge_task_handle) {
+        hedge_task_handle->disable();
+        hedge_task_handle = nullptr;
+    }
+
+    if (!res_handler) {
+        return;
+    }
+
+    auto tmp_res_handler = std::move(res_handler);
+    res_handler = nullptr;
+    tmp_res_handler(std::move(res));
+}
+
+
+template<typename Req, typename Res>
+class hedging_request_handler : public request_handler<Req, Res>, public std::enable_shared_from_this<hedging_request_handler<Req, Res>>
+{
+public:
+    hedging_request_handler(
+        event_loop &evloop, const hedging_delay_config &delay_config,
+        std::shared_ptr<request_handler<Req, Res>> &&primary_req_handler,
+        std::shared_ptr<request_handler<Req, Res>> &&secondary_req_handler);
+
+    void handle_request(Req &&request, std::chrono::nanoseconds timeout, result_handler<Res> &&res_handler) override;
+
+private:
+    std::chrono::nanoseconds get_hedge_delay() const;
+    void save_primary_latency(std::chrono::nanoseconds latency);
+    void update_percentile_latency();
+
+    event_loop &evloop;
+    hedging_delay_config delay_config;
+    std::shared_ptr<request_handler<Req, Res>> primary_req_handler;
+    std::shared_ptr<request_handler<Req, Res>> secondary_req_handler;
+    std::deque<std::chrono::nanoseconds> primary_latencies;
+    std::experimental::optional<std::chrono::nanoseconds> percentile_latency;
+};
+
+
+template<typename Req, typename Res>
+hedging_request_handler<Req, Res>::hedging_request_handler(
+    event_loop &evloop, const hedging_delay_config &delay_config,
+    std::shared_ptr<request_handler<Req, Res>> &&primary_req_handler,
+    std::shared_ptr<request_handler<Req, Res>> &&secondary_req_handler)
+    : evloop(evloop), delay_config(delay_config), primary_req_handler(std::move(primary_req_handler)),
+    secondary_req_handler(std::move(secondary_req_handler)), primary_latencies(), percentile_latency()
+{
+}
+
+
+template<typename Req, typename Res>
+void hedging_request_handler<Req, Res>::handle_request(
+    Req &&request, std::chrono::nanoseconds timeout, result_handler<Res> &&res_handler)
+{
+    const auto req_start_time = evloop.get_etime();
+    const auto timeout_end = time_point_sat_add(req_start_time, timeout);
+    const auto hedge_delay = get_hedge_delay();
+
+    auto ctx = std::make_shared<hedged_request_context<Res>>(std::move(res_handler));
+
+    if (hedge_delay < timeout) {
+        ctx->hedge_task_handle = evloop.invoke_at(
+            time_point_sat_add(req_start_time, hedge_delay),
+            [req_handler_wptr = weak_from_that(this), ctx_wptr = weak_from_shared(ctx), request, timeout_end]() mutable {
+                auto req_handler_ptr = req_handler_wptr.lock();
+                auto ctx_ptr = ctx_wptr.lock();
+                if (!req_handler_ptr || !ctx_ptr) {
+                    return;
+                }
+
+                ctx_ptr->hedge_task_handle = nullptr;
+                req_handler_ptr->secondary_req_handler->handle_request(
+                    std::move(request), std::max(timeout_end - req_handler_ptr->evloop.get_etime(), std::chrono::nanoseconds(0)),
+                    [ctx = std::move(ctx_ptr)](auto res) {
+                        ctx->call_res_handler_once(std::move(res));
+                    });
+            });
+    }
+
+    primary_req_handler->handle_request(
+        std::move(request), timeout,
+        [req_handler_wptr = weak_from_that(this), req_start_time, ctx](auto res) {
+            auto req_handler_ptr = req_handler_wptr.lock();
+            if (req_handler_ptr && res.is_ok()) {
+                req_handler_ptr->save_primary_latency(req_handler_ptr->evloop.get_etime() - req_start_time);
+            }
+
+            ctx->call_res_handler_once(std::move(res));
+        });
+}
+
+
+template<typename Req, typename Res>
+std::chrono::nanoseconds hedging_request_handler<Req, Res>::get_hedge_delay() const
+{
+    return percentile_latency ? *percentile_latency : delay_config.hedge_delay;
+}
+
+
+template<typename Req, typename Res>
+void hedging_request_handler<Req, Res>::save_primary_latency(std::chrono::nanoseconds latency)
+{
+    if (delay_config.latency_percentile <= 0 || delay_config.latency_window_size == 0) {
+        return;
+    }
+
+    primary_latencies.push_back(latency);
+    if (primary_latencies.size() > delay_config.latency_window_size) {
+        primary_latencies.pop_front();
+    }
+
+    update_percentile_latency();
+}
+
+
+template<typename Req, typename Res>
+void hedging_request_handler<Req, Res>::update_percentile_latency()
+{
+    if (primary_latencies.empty() || primary_latencies.size() < delay_config.latency_window_size) {
+        return;
+    }
+
+    std::vector<std::chrono::nanoseconds> latencies(primary_latencies.begin(), primary_latencies.end());
+    const auto percentile_index = std::max(
+        std::min(
+            static_cast<std::size_t>(std::ceil(delay_config.latency_percentile * latencies.size())),
+            latencies.size()),
+        static_cast<std::size_t>(1U)) - 1;
+    std::nth_element(latencies.begin(), latencies.begin() + percentile_index, latencies.end());
+
+    percentile_latency = latencies[percentile_index];
+}
+
+}
+
+
+template<typename Req, typename Res>
+std::shared_ptr<request_handler<Req, Res>> make_hedging_request_handler(
+    event_loop &evloop, const hedging_delay_config &delay_config,
+    std::shared_ptr<request_handler<Req, Res>> &&primary_req_handler,
+    std::shared_ptr<request_handler<Req, Res>> &&secondary_req_handler)
+{
+    if (delay_config.latency_percentile > 0
+        && (delay_config.latency_percentile > 1 || delay_config.latency_window_size == 0)) {
+        throw std::invalid_argument("hedging latency percentile must be in (0, 1] range with non-empty window");
+    }
+
+    return std::make_shared<hedging_request_handler_impl::hedging_request_handler<Req, Res>>(
+        evloop, delay_config, std::move(primary_req_handler), std::move(secondary_req_handler));
+}
+
+}
+
+#endif /* NOSYNC__HEDGING_REQUEST_HANDLER_IMPL_H */
@@ -0,0 +1,56 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#ifndef NOSYNC__HEDGING_REQUEST_HANDLER_H
+#define NOSYNC__HEDGING_REQUEST_HANDLER_H
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <nosync/event-loop.h>
+#include <nosync/request-handler.h>
+
+
+namespace nosync
+{
+
+/*!
+Configuration of delay after which hedging request is sent.
+
+ - hedge_delay - the delay, used also while less than latency_window_size
+latencies are observed when latency_percentile is used,
+ - latency_percentile - if non-zero, the delay is set to this percentile (in
+range (0, 1]) of latencies of last latency_window_size responses of primary
+request_handler (only successful responses are taken into account, the
+percentile is recomputed when the window changes).
+
+Non-zero latency_percentile requires non-zero latency_window_size.
+*/
+struct hedging_delay_config
+{
+    std::chrono::nanoseconds hedge_delay;
+    double latency_percentile;
+    std::size_t latency_window_size;
+};
+
+
+/*!
+Create request_handler<> decorator which sends duplicates of slow requests to secondary request_handler.
+
+Each request is forwarded to primary request_handler. If there's no response
+from it after hedging delay (measured in event loop time), a copy of the request
+is forwarded also to secondary request_handler (with the remaining timeout). The
+first response received is returned, the other one is ignored.
+
+To be used only for idempotent requests, Req type must be copyable. Invalid
+delay configuration is reported with std::invalid_argument exception.
+*/
+template<typename Req, typename Res>
+std::shared_ptr<request_handler<Req, Res>> make_hedging_request_handler(
+    event_loop &evloop, const hedging_delay_config &delay_config,
+    std::shared_ptr<request_handler<Req, Res>> &&primary_req_handler,
+    std::shared_ptr<request_handler<Req, Res>> &&secondary_req_handler);
+
+}
+
+#include <nosync/hedging-request-handler-impl.h>
+
+#endif /* NOSYNC__HEDGING_REQUEST_HANDLER_H */
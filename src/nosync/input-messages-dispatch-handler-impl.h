@@ -0,0 +1,250 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#ifndef NOSYNC__INPUT_MESSAGES_DISPATCH_HANDLER_IMPL_H
+#define NOSYNC__INPUT_MESSAGES_DISPATCH_HANDLER_IMPL_H
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <nosync/eclock.h>
+#include <nosync/event-loop-utils.h>
+#include <nosync/memory-utils.h>
+#include <nosync/raw-error-result.h>
+#include <nosync/requests-queue.h>
+#include <nosync/result-utils.h>
+#include <nosync/time-utils.h>
+#include <set>
+#include <system_error>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+namespace nosync
+{
+
+namespace input_messages_dispatch_handler_impl
+{
+
+template<typename Id>
+class input_messages_dispatch_handler : public request_handler<Id, std::string>, public std::enable_shared_from_this<input_messages_dispatch_handler<Id>>
+{
+public:
+    input_messages_dispatch_handler(
+        event_loop &evloop, std::shared_ptr<request_handler<std::nullptr_t, std::string>> &&messages_reader,
+        std::function<std::experimental::optional<Id>(std::experimental::string_view)> &&message_id_decoder);
+    ~input_messages_dispatch_handler() override;
+
+    void handle_request(
+        Id &&msg_id, std::chrono::nanoseconds timeout,
+        result_handler<std::string> &&res_handler) override;
+
+private:
+    void add_pending_request(
+        Id &&msg_id, std::chrono::time_point<eclock> timeout_end, result_handler<std::string> &&res_handler);
+    result_handler<std::string> pull_pending_request(std::uint64_t req_seq);
+    void read_next_message_if_needed();
+    void handle_pending_requests_timeouts();
+    std::experimental::optional<result_handler<std::string>> try_pull_matching_pending_handler(std::experimental::string_view message);
+
+    event_loop &evloop;
+    std::shared_ptr<request_handler<std::nullptr_t, std::string>> messages_reader;
+    std::function<std::experimental::optional<Id>(std::experimental::string_view)> message_id_decoder;
+    bool read_ongoing;
+    std::uint64_t next_req_seq;
+    std::map<std::uint64_t, std::tuple<Id, std::chrono::time_point<eclock>, result_handler<std::string>>> pending_requests;
+    std::unordered_map<Id, std::deque<std::uint64_t>> pending_req_seqs_by_id;
+    std::set<std::tuple<std::chrono::time_point<eclock>, std::uint64_t>> pending_req_timeouts;
+    requests_queue<Id, std::string> new_pending_requests;
+};
+
+
+template<typename Id>
+input_messages_dispatch_handler<Id>::input_messages_dispatch_handler(
+    event_loop &evloop, std::shared_ptr<request_handler<std::nullptr_t, std::string>> &&messages_reader,
+    std::function<std::experimental::optional<Id>(std::experimental::string_view)> &&message_id_decoder)
+    : evloop(evloop), messages_reader(std::move(messages_reader)), message_id_decoder(std::move(message_id_decoder)),
+    read_ongoing(false), next_req_seq(0), pending_requests(), pending_req_seqs_by_id(), pending_req_timeouts(),
+    new_pending_requests(evloop)
+{
+}
+
+
+template<typename Id>
+input_messages_dispatch_handler<Id>::~input_messages_dispatch_handler()
+{
+    if (!pending_requests.empty()) {
+        invoke_later(
+            evloop,
+            [cancel_requests = std::move(pending_requests)]() mutable {
+                for (auto &req : cancel_requests) {
+                    auto &res_handler = std::get<result_handler<std::string>>(req.second);
+                    res_handler(raw_error_result(std::errc::operation_canceled));
+                    res_handler = nullptr;
+                }
+            });
+    }
+}
+
+
+template<typename Id>
+void input_messages_dispatch_handler<Id>::handle_request(
+    Id &&msg_id, std::chrono::nanoseconds timeout, result_handler<std::string> &&res_handler)
+{
+    if (!read_ongoing) {
+        add_pending_request(
+            std::move(msg_id), time_point_sat_add(evloop.get_etime(), timeout), std::move(res_handler));
+        read_next_message_if_needed();
+    } else {
+        new_pending_requests.push_request(
+            std::move(msg_id), time_point_sat_add(evloop.get_etime(), timeout), std::move(res_handler));
+    }
+}
+
+
+template<typename Id>
+void input_messages_dispatch_handler<Id>::add_pending_request(
+    Id &&msg_id, std::chrono::time_point<eclock> timeout_end, result_handler<std::string> &&res_handler)
+{
+    const auto req_seq = next_req_seq;
+    ++next_req_seq;
+
+    pending_req_seqs_by_id[msg_id].push_back(req_seq);
+    pending_req_timeouts.emplace(timeout_end, req_seq);
+    pending_requests.emplace(req_seq, std::make_tuple(std::move(msg_id), timeout_end, std::move(res_handler)));
+}
+
+
+template<typename Id>
+result_handler<std::string> input_messages_dispatch_handler<Id>::pull_pending_request(std::uint64_t req_seq)
+{
+    auto req_iter = pending_requests.find(req_seq);
+    auto &req = req_iter->second;
+
+    auto id_seqs_iter = pending_req_seqs_by_id.find(std::get<Id>(req));
+    auto &id_seqs = id_seqs_iter->second;
+    id_seqs.erase(std::find(id_seqs.begin(), id_seqs.end(), req_seq));
+    if (id_seqs.empty()) {
+        pending_req_seqs_by_id.erase(id_seqs_iter);
+    }
+
+    pending_req_timeouts.erase(std::make_tuple(std::get<std::chrono::time_point<eclock>>(req), req_seq));
+
+    auto res_handler = std::move(std::get<result_handler<std::string>>(req));
+    pending_requests.erase(req_iter);
+
+    return res_handler;
+}
+
+
+template<typename Id>
+void input_messages_dispatch_handler<Id>::read_next_message_if_needed()
+{
+    namespace ch = std::chrono;
+
+    if (pending_requests.empty() || read_ongoing) {
+        return;
+    }
+
+    const auto min_timeout_end = std::get<ch::time_point<eclock>>(*pending_req_timeouts.begin());
+
+    messages_reader->handle_request(
+        nullptr,
+        std::max(min_timeout_end - evloop.get_etime(), ch::nanoseconds(0)),
+        [disp_handler_wptr = weak_from_that(this)](auto read_res) {
+            auto disp_handler_ptr = disp_handler_wptr.lock();
+            if (!disp_handler_ptr) {
+                return;
+            }
+
+            disp_handler_ptr->read_ongoing = false;
+
+            while (disp_handler_ptr->new_pending_requests.has_requests()) {
+                auto new_req = disp_handler_ptr->new_pending_requests.pull_next_request();
+                disp_handler_ptr->add_pending_request(
+                    std::move(std::get<Id>(new_req)), std::get<ch::time_point<eclock>>(new_req),
+                    std::move(std::get<result_handler<std::string>>(new_req)));
+            }
+
+            std::experimental::optional<result_handler<std::string>> res_handler;
+            if (read_res.is_ok()) {
+                res_handler = disp_handler_ptr->try_pull_matching_pending_handler(read_res.get_value());
+            } else {
+                if (!disp_handler_ptr->pending_requests.empty() && read_res.get_error() != std::make_error_code(std::errc::timed_out)) {
+                    res_handler = disp_handler_ptr->pull_pending_request(
+                        disp_handler_ptr->pending_requests.begin()->first);
+                }
+            }
+
+            if (res_handler) {
+                (*res_handler)(read_res);
+            }
+
+            disp_handler_ptr->handle_pending_requests_timeouts();
+
+            disp_handler_ptr->read_next_message_if_needed();
+        });
+    read_ongoing = true;
+}
+
+
+template<typename Id>
+void input_messages_dispatch_handler<Id>::handle_pending_requests_timeouts()
+{
+    const auto now = evloop.get_etime();
+
+    std::vector<std::uint64_t> timeouted_req_seqs;
+    for (const auto &req_timeout : pending_req_timeouts) {
+        if (std::get<std::chrono::time_point<eclock>>(req_timeout) > now) {
+            break;
+        }
+        timeouted_req_seqs.push_back(std::get<std::uint64_t>(req_timeout));
+    }
+
+    std::sort(timeouted_req_seqs.begin(), timeouted_req_seqs.end());
+
+    std::vector<result_handler<std::string>> timeouted_res_handlers;
+    for (auto req_seq : timeouted_req_seqs) {
+        timeouted_res_handlers.push_back(pull_pending_request(req_seq));
+    }
+
+    for (auto &res_handler : timeouted_res_handlers) {
+        res_handler(make_timeout_raw_error_result());
+        res_handler = nullptr;
+    }
+}
+
+
+template<typename Id>
+std::experimental::optional<result_handler<std::string>> input_messages_dispatch_handler<Id>::try_pull_matching_pending_handler(
+    std::experimental::string_view message)
+{
+    auto msg_id = message_id_decoder(message);
+    if (!msg_id) {
+        return std::experimental::nullopt;
+    }
+
+    auto id_seqs_iter = pending_req_seqs_by_id.find(*msg_id);
+    if (id_seqs_iter == pending_req_seqs_by_id.end()) {
+        return std::experimental::nullopt;
+    }
+
+    return pull_pending_request(id_seqs_iter->second.front());
+}
+
+}
+
+
+template<typename Id>
+std::shared_ptr<request_handler<Id, std::string>> make_input_messages_dispatch_handler(
+    event_loop &evloop, std::shared_ptr<request_handler<std::nullptr_t, std::string>> &&messages_reader,
+    std::function<std::experimental::optional<Id>(std::experimental::string_view)> &&message_id_decoder)
+{
+    return std::make_shared<input_messages_dispatch_handler_impl::input_messages_dispatch_handler<Id>>(
+        evloop, std::move(messages_reader), std::move(message_id_decoder));
+}
+
+}
+
+#endif /* NOSYNC__INPUT_MESSAGES_DISPATCH_HANDLER_IMPL_H */
@@ -4,6 +4,7 @@
 
 #include <experimental/optional>
 #include <experimental/string_view>
+#include <functional>
 #include <nosync/bytes-reader.h>
 #include <nosync/event-loop.h>
 #include <nosync/request-handler.h>
@@ -18,6 +19,19 @@ std::shared_ptr<request_handler<std::string, std::string>> make_input_messages_d
     event_loop &evloop, std::shared_ptr<request_handler<std::nullptr_t, std::string>> &&messages_reader,
     std::function<std::experimental::optional<std::string>(std::experimental::string_view)> &&message_id_decoder);
 
+/*!
+Variant of make_input_messages_dispatch_handler() with message ids of any hashable type.
+
+Decoding message ids directly to e.g. integers lets the handler match messages
+with pending requests without allocating a string for each message.
+*/
+template<typename Id>
+std::shared_ptr<request_handler<Id, std::string>> make_input_messages_dispatch_handler(
+    event_loop &evloop, std::shared_ptr<request_handler<std::nullptr_t, std::string>> &&messages_reader,
+    std::function<std::experimental::optional<Id>(std::experimental::string_view)> &&message_id_decoder);
+
 }
 
+#include <nosync/input-messages-dispatch-handler-impl.h>
+
 #endif /* NOSYNC__INPUT_MESSAGES_DISPATCH_HANDLER_H */
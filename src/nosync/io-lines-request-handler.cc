@@ -1,6 +1,7 @@
 // This file is part of libnosync library. See LICENSE file for license details.
 #include <experimental/optional>
 #include <experimental/string_view>
+#include <nosync/coalescing-chunks-writer.h>
 #include <nosync/input-messages-dispatch-handler.h>
 #include <nosync/io-lines-request-handler.h>
 #include <nosync/lines-reader.h>
@@ -9,6 +10,7 @@
 #include <nosync/sequential-chunks-writer.h>
 #include <nosync/string-utils.h>
 #include <nosync/time-utils.h>
+#include <nosync/type-utils.h>
 
 namespace ch = std::chrono;
 using namespace std::string_literals;
@@ -75,18 +77,30 @@ string encode_request_line(uint64_t req_id, string_view req_data)
 }
 
 
-string encode_request_id(uint64_t req_id)
+optional<uint64_t> try_decode_response_line_id(string_view resp_line)
 {
-    return make_string(number_to_hex_digits_array(req_id));
-}
-
+    constexpr auto req_id_hex_size = sizeof(uint64_t) * 2;
 
-optional<string> try_decode_response_line_id(string_view resp_line)
-{
     auto sep_pos = resp_line.find(req_id_separator);
-    return sep_pos != string_view::npos
-        ? std::experimental::make_optional(resp_line.substr(0, sep_pos).to_string())
-        : nullopt;
+    if (sep_pos != req_id_hex_size) {
+        return nullopt;
+    }
+
+    const auto req_id_hex = resp_line.substr(0, sep_pos);
+    uint64_t req_id = 0;
+    for (auto hex_digit : req_id_hex) {
+        auto digit_value = try_number_from_hex_digit(hex_digit);
+        if (!digit_value) {
+            return nullopt;
+        }
+        req_id = (req_id << 4) | *digit_value;
+    }
+
+    if (req_id_hex != make_string_view(number_to_hex_digits_array(req_id))) {
+        return nullopt;
+    }
+
+    return req_id;
 }
 
 
@@ -100,7 +114,9 @@ string decode_response_line_data(string_view resp_line)
 class io_lines_request_handler : public request_handler<string, string>
 {
 public:
-    io_lines_request_handler(event_loop &evloop, const shared_ptr<bytes_io> &lines_io);
+    io_lines_request_handler(
+        event_loop &evloop, const shared_ptr<bytes_io> &lines_io,
+        shared_ptr<request_handler<string, void>> &&req_lines_writer);
 
     void handle_request(
         string &&data, ch::nanoseconds timeout,
@@ -108,18 +124,20 @@ public:
 
 private:
     event_loop &evloop;
-    shared_ptr<request_handler<string, string>> resp_lines_dispatcher;
+    shared_ptr<request_handler<uint64_t, string>> resp_lines_dispatcher;
     shared_ptr<request_handler<string, void>> req_lines_writer;
     uint64_t next_req_id;
 };
 
 
-io_lines_request_handler::io_lines_request_handler(event_loop &evloop, const shared_ptr<bytes_io> &lines_io)
+io_lines_request_handler::io_lines_request_handler(
+    event_loop &evloop, const shared_ptr<bytes_io> &lines_io,
+    shared_ptr<request_handler<string, void>> &&req_lines_writer)
     : evloop(evloop),
     resp_lines_dispatcher(
-        make_input_messages_dispatch_handler(
+        make_input_messages_dispatch_handler<uint64_t>(
             evloop, make_lines_reader(evloop, lines_io), try_decode_response_line_id)),
-    req_lines_writer(make_sequential_chunks_writer(evloop, lines_io)),
+    req_lines_writer(move(req_lines_writer)),
     next_req_id(0)
 {
 }
@@ -140,7 +158,7 @@ void io_lines_request_handler::handle_request(
     auto ctx = make_shared<request_context>(move(res_handler));
 
     resp_lines_dispatcher->handle_request(
-        encode_request_id(req_id), timeout,
+        make_copy(req_id), timeout,
         [ctx](auto resp_res) {
             auto resp_data = make_ok_result(decode_response_line_data(resp_res.get_value()));
             if (ctx->saved_req_res) {
@@ -171,7 +189,16 @@ void io_lines_request_handler::handle_request(
 shared_ptr<request_handler<string, string>> make_io_lines_request_handler(
     event_loop &evloop, const shared_ptr<bytes_io> &lines_io)
 {
-    return make_shared<io_lines_request_handler>(evloop, lines_io);
+    return make_shared<io_lines_request_handler>(
+        evloop, lines_io, make_sequential_chunks_writer(evloop, lines_io));
+}
+
+
+shared_ptr<request_handler<string, string>> make_coalescing_io_lines_request_handler(
+    event_loop &evloop, const shared_ptr<bytes_io> &lines_io)
+{
+    return make_shared<io_lines_request_handler>(
+        evloop, lines_io, make_coalescing_chunks_writer(evloop, lines_io));
 }
 
 }
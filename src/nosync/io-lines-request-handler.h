@@ -15,6 +15,15 @@ namespace nosync
 std::shared_ptr<request_handler<std::string, std::string>> make_io_lines_request_handler(
     event_loop &evloop, const std::shared_ptr<bytes_io> &lines_io);
 
+/*!
+Variant of make_io_lines_request_handler() which writes request lines in batches.
+
+All request lines queued within single event loop iteration (or while previous
+write is ongoing) are sent with single write to lines_io.
+*/
+std::shared_ptr<request_handler<std::string, std::string>> make_coalescing_io_lines_request_handler(
+    event_loop &evloop, const std::shared_ptr<bytes_io> &lines_io);
+
 }
 
 #endif /* NOSYNC__IO_LINES_REQUEST_HANDLER_H */
@@ -0,0 +1,152 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#ifndef NOSYNC__LOAD_BALANCING_REQUEST_HANDLER_IMPL_H
+#define NOSYNC__LOAD_BALANCING_REQUEST_HANDLER_IMPL_H
+
+#include <cstddef>
+#include <nosync/memory-utils.h>
+#include <random>
+#include <stdexcept>
+#include <utility>
+
+
+namespace nosync
+{
+
+namespace load_balancing_request_handler_impl
+{
+
+template<typename Req, typename Res>
+class load_balancing_request_handler : public request_handler<Req, Res>, public std::enable_shared_from_this<load_balancing_request_handler<Req, Res>>
+{
+public:
+    load_balancing_request_handler(
+        load_balancing_policy policy, std::vector<std::shared_ptr<request_handler<Req, Res>>> &&backend_req_handlers,
+        std::uint_fast32_t random_seed);
+
+    void handle_request(Req &&request, std::chrono::nanoseconds timeout, result_handler<Res> &&res_handler) override;
+
+private:
+    std::size_t choose_backend();
+    std::size_t choose_least_outstanding_backend();
+    std::size_t choose_random_backends_pair_backend();
+
+    load_balancing_policy policy;
+    std::vector<std::shared_ptr<request_handler<Req, Res>>> backend_req_handlers;
+    std::vector<std::size_t> in_flight_counts;
+    std::size_t next_backend_index;
+    std::minstd_rand random_engine;
+};
+
+
+template<typename Req, typename Res>
+load_balancing_request_handler<Req, Res>::load_balancing_request_handler(
+    load_balancing_policy policy, std::vector<std::shared_ptr<request_handler<Req, Res>>> &&backend_req_handlers,
+    std::uint_fast32_t random_seed)
+    : policy(policy), backend_req_handlers(std::move(backend_req_handlers)),
+    in_flight_counts(this->backend_req_handlers.size(), 0), next_backend_index(0),
+    random_engine(random_seed)
+{
+    if (this->backend_req_handlers.empty()) {
+        throw std::invalid_argument("load balancing requires at least one backend");
+    }
+}
+
+
+template<typename Req, typename Res>
+void load_balancing_request_handler<Req, Res>::handle_request(
+    Req &&request, std::chrono::nanoseconds timeout, result_handler<Res> &&res_handler)
+{
+    const auto backend_index = choose_backend();
+
+    ++in_flight_counts[backend_index];
+    backend_req_handlers[backend_index]->handle_request(
+        std::move(request), timeout,
+        [req_handler_wptr = weak_from_that(this), backend_index, res_handler = std::move(res_handler)](auto res) {
+            auto req_handler_ptr = req_handler_wptr.lock();
+            if (req_handler_ptr) {
+                --req_handler_ptr->in_flight_counts[backend_index];
+            }
+
+            res_handler(std::move(res));
+        });
+}
+
+
+template<typename Req, typename Res>
+std::size_t load_balancing_request_handler<Req, Res>::choose_backend()
+{
+    switch (policy) {
+    case load_balancing_policy::least_outstanding:
+        return choose_least_outstanding_backend();
+    case load_balancing_policy::power_of_two_choices:
+        return choose_random_backends_pair_backend();
+    case load_balancing_policy::round_robin:
+        break;
+    }
+
+    const auto backend_index = next_backend_index;
+    next_backend_index = (next_backend_index + 1) % backend_req_handlers.size();
+
+    return backend_index;
+}
+
+
+template<typename Req, typename Res>
+std::size_t load_balancing_request_handler<Req, Res>::choose_least_outstanding_backend()
+{
+    const auto backends_count = backend_req_handlers.size();
+
+    auto best_index = next_backend_index;
+    for (std::size_t i = 1; i < backends_count; ++i) {
+        const auto index = (next_backend_index + i) % backends_count;
+        if (in_flight_counts[index] < in_flight_counts[best_index]) {
+            best_index = index;
+        }
+    }
+
+    next_backend_index = (best_index + 1) % backends_count;
+
+    return best_index;
+}
+
+
+template<typename Req, typename Res>
+std::size_t load_balancing_request_handler<Req, Res>::choose_random_backends_pair_backend()
+{
+    const auto backends_count = backend_req_handlers.size();
+    if (backends_count == 1) {
+        return 0;
+    }
+
+    const auto first_index = std::uniform_int_distribution<std::size_t>(0, backends_count - 1)(random_engine);
+    auto second_index = std::uniform_int_distribution<std::size_t>(0, backends_count - 2)(random_engine);
+    if (second_index >= first_index) {
+        ++second_index;
+    }
+
+    return in_flight_counts[second_index] < in_flight_counts[first_index] ? second_index : first_index;
+}
+
+}
+
+
+template<typename Req, typename Res>
+std::shared_ptr<request_handler<Req, Res>> make_load_balancing_request_handler(
+    load_balancing_policy policy, std::vector<std::shared_ptr<request_handler<Req, Res>>> &&backend_req_handlers)
+{
+    return make_load_balancing_request_handler(policy, std::move(backend_req_handlers), std::random_device()());
+}
+
+
+template<typename Req, typename Res>
+std::shared_ptr<request_handler<Req, Res>> make_load_balancing_request_handler(
+    load_balancing_policy policy, std::vector<std::shared_ptr<request_handler<Req, Res>>> &&backend_req_handlers,
+    std::uint_fast32_t random_seed)
+{
+    return std::make_shared<load_balancing_request_handler_impl::load_balancing_request_handler<Req, Res>>(
+        policy, std::move(backend_req_handlers), random_seed);
+}
+
+}
+
+#endif /* NOSYNC__LOAD_BALANCING_REQUEST_HANDLER_IMPL_H */
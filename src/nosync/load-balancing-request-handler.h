@@ -0,0 +1,55 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#ifndef NOSYNC__LOAD_BALANCING_REQUEST_HANDLER_H
+#define NOSYNC__LOAD_BALANCING_REQUEST_HANDLER_H
+
+#include <cstdint>
+#include <memory>
+#include <nosync/request-handler.h>
+#include <vector>
+
+
+namespace nosync
+{
+
+/*!
+Policy of choosing backend request_handler for a request.
+
+ - round_robin - backends are used in turns,
+ - least_outstanding - backend with the lowest number of requests in flight
+is used (ties are resolved in round robin order),
+ - power_of_two_choices - two different backends are chosen at random and
+the one with lower number of requests in flight is used.
+*/
+enum class load_balancing_policy
+{
+    round_robin,
+    least_outstanding,
+    power_of_two_choices,
+};
+
+
+/*!
+Create request_handler<> which spreads requests across several equivalent backend request_handlers.
+
+Each request is forwarded (without any queueing) to a single backend chosen
+according to the policy. The number of requests in flight (forwarded, but not
+yet responded) is tracked per backend. The list of backends must be non-empty
+(std::invalid_argument is thrown otherwise).
+
+The random choices of power_of_two_choices policy are made with pseudo-random
+generator seeded with random_seed (if not given, std::random_device is used).
+*/
+template<typename Req, typename Res>
+std::shared_ptr<request_handler<Req, Res>> make_load_balancing_request_handler(
+    load_balancing_policy policy, std::vector<std::shared_ptr<request_handler<Req, Res>>> &&backend_req_handlers);
+
+template<typename Req, typename Res>
+std::shared_ptr<request_handler<Req, Res>> make_load_balancing_request_handler(
+    load_balancing_policy policy, std::vector<std::shared_ptr<request_handler<Req, Res>>> &&backend_req_handlers,
+    std::uint_fast32_t random_seed);
+
+}
+
+#include <nosync/load-balancing-request-handler-impl.h>
+
+#endif /* NOSYNC__LOAD_BALANCING_REQUEST_HANDLER_H */
@@ -3,10 +3,13 @@
 #define NOSYNC__MULTI_SEQUENTIAL_REQUEST_HANDLER_IMPL_H
 
 #include <map>
+#include <nosync/memory-utils.h>
 #include <nosync/multi-sequential-request-handler.h>
 #include <nosync/sequential-request-handler.h>
 #include <nosync/type-utils.h>
 #include <tuple>
+#include <type_traits>
+#include <unordered_map>
 
 
 namespace nosync
@@ -15,8 +18,12 @@ namespace nosync
 namespace multi_sequential_request_handler_impl
 {
 
+template<typename K, typename V>
+using hashed_or_ordered_map = std::conditional_t<is_std_hashable<K>, std::unordered_map<K, V>, std::map<K, V>>;
+
+
 template<typename Req, typename Res, typename K>
-class multi_sequential_request_handler : public request_handler<Req, Res>
+class multi_sequential_request_handler : public request_handler<Req, Res>, public std::enable_shared_from_this<multi_sequential_request_handler<Req, Res, K>>
 {
 public:
     multi_sequential_request_handler(
@@ -31,7 +38,7 @@ private:
     event_loop &evloop;
     std::shared_ptr<request_handler<Req, Res>> base_req_handler;
     std::function<K(const Req &)> sequence_key_func;
-    std::map<K, std::shared_ptr<request_handler<Req, Res>>> sub_req_handlers;
+    hashed_or_ordered_map<K, std::tuple<std::shared_ptr<request_handler<Req, Res>>, std::size_t>> sub_req_handlers;
 };
 
 
@@ -49,16 +56,33 @@ template<typename Req, typename Res, typename K>
 void multi_sequential_request_handler<Req, Res, K>::handle_request(
     Req &&request, std::chrono::nanoseconds timeout, result_handler<Res> &&res_handler)
 {
-    const auto sequence_key = sequence_key_func(request);
+    auto sequence_key = sequence_key_func(request);
     auto sub_req_handler_iter = sub_req_handlers.find(sequence_key);
     if (sub_req_handler_iter == sub_req_handlers.end()) {
         std::tie(sub_req_handler_iter, std::ignore) = sub_req_handlers.emplace(
-            sequence_key, make_sequential_request_handler(evloop, make_copy(base_req_handler)));
+            sequence_key,
+            std::make_tuple(make_sequential_request_handler(evloop, make_copy(base_req_handler)), std::size_t(0)));
     }
 
-    // TODO: remove unused sub-handlers
-    sub_req_handler_iter->second->handle_request(
-        std::move(request), timeout, std::move(res_handler));
+    auto &sub_req_handler = std::get<std::shared_ptr<request_handler<Req, Res>>>(sub_req_handler_iter->second);
+    ++std::get<std::size_t>(sub_req_handler_iter->second);
+
+    // sub-handler is removed as soon as all its requests are finished, as
+    // there is nothing left in its queue at that point
+    sub_req_handler->handle_request(
+        std::move(request), timeout,
+        [req_handler_wptr = weak_from_that(this), sequence_key = std::move(sequence_key), res_handler = std::move(res_handler)](auto res) {
+            auto req_handler_ptr = req_handler_wptr.lock();
+            if (req_handler_ptr) {
+                auto &sub_req_handlers = req_handler_ptr->sub_req_handlers;
+                auto sub_req_handler_iter = sub_req_handlers.find(sequence_key);
+                if (sub_req_handler_iter != sub_req_handlers.end() && --std::get<std::size_t>(sub_req_handler_iter->second) == 0) {
+                    sub_req_handlers.erase(sub_req_handler_iter);
+                }
+            }
+
+            res_handler(std::move(res));
+        });
 }
 
 }
@@ -1,9 +1,13 @@
 // This file is part of libnosync library. See LICENSE file for license details.
+#include <arpa/inet.h>
+#include <array>
 #include <cstddef>
 #include <cstring>
 #include <endian.h>
+#include <initializer_list>
 #include <netinet/in.h>
 #include <netinet/ip.h>
+#include <netinet/tcp.h>
 #include <nosync/net-utils.h>
 #include <nosync/raw-error-result.h>
 #include <nosync/result-utils.h>
@@ -12,8 +16,11 @@
 #include <sys/un.h>
 #include <system_error>
 #include <utility>
+#include <vector>
 
+using std::array;
 using std::errc;
+using std::experimental::optional;
 using std::error_code;
 using std::make_error_code;
 using std::make_unique;
@@ -24,6 +31,7 @@ using std::tuple;
 using std::uint16_t;
 using std::uint32_t;
 using std::unique_ptr;
+using std::vector;
 
 
 namespace nosync
@@ -32,6 +40,9 @@ namespace nosync
 namespace
 {
 
+constexpr auto max_local_datagram_buffer_size = 8192U;
+
+
 class un_socket_address : public socket_address
 {
 public:
@@ -65,20 +76,19 @@ private:
 };
 
 
-class any_socket_address : public socket_address
+class in6_socket_address : public socket_address
 {
 public:
-    any_socket_address(const ::sockaddr_storage &addr, size_t addr_size);
+    explicit in6_socket_address(const ::sockaddr_in6 &addr);
 
-    any_socket_address(const any_socket_address &) = default;
-    any_socket_address(any_socket_address &&) = default;
+    in6_socket_address(const in6_socket_address &) = default;
+    in6_socket_address(in6_socket_address &&) = default;
 
     int get_address_family() const override;
     socket_address_view get_view() const override;
 
 private:
-    ::sockaddr_storage addr;
-    size_t addr_size;
+    ::sockaddr_in6 addr;
 };
 
 
@@ -119,22 +129,21 @@ socket_address_view in_socket_address::get_view() const
 
 
 
-
-any_socket_address::any_socket_address(const ::sockaddr_storage &addr, size_t addr_size)
-    : addr(addr), addr_size(addr_size)
+in6_socket_address::in6_socket_address(const ::sockaddr_in6 &addr)
+    : addr(addr)
 {
 }
 
 
-int any_socket_address::get_address_family() const
+int in6_socket_address::get_address_family() const
 {
-    return addr.ss_family;
+    return AF_INET6;
 }
 
 
-socket_address_view any_socket_address::get_view() const
+socket_address_view in6_socket_address::get_view() const
 {
-    return {reinterpret_cast<const ::sockaddr *>(&addr), addr_size};
+    return {reinterpret_cast<const ::sockaddr *>(&addr), sizeof(addr)};
 }
 
 
@@ -303,6 +312,69 @@ unique_ptr<socket_address> make_ipv4_localhost_socket_address(uint16_t port)
 }
 
 
+unique_ptr<socket_address> make_ipv6_socket_address(const array<uint8_t, 16> &host_addr, uint16_t port, uint32_t scope_id)
+{
+    ::sockaddr_in6 addr = {};
+    addr.sin6_family = AF_INET6;
+    addr.sin6_port = static_cast<in_port_t>(htobe16(port));
+    std::memcpy(addr.sin6_addr.s6_addr, host_addr.data(), host_addr.size());
+    addr.sin6_scope_id = scope_id;
+
+    return make_unique<in6_socket_address>(addr);
+}
+
+
+unique_ptr<socket_address> make_ipv6_localhost_socket_address(uint16_t port)
+{
+    array<uint8_t, 16> host_addr = {};
+    host_addr.back() = 1;
+
+    return make_ipv6_socket_address(host_addr, port);
+}
+
+
+result<unique_ptr<socket_address>> make_numeric_ip_socket_address(const string &host_addr, uint16_t port)
+{
+    if (host_addr.find(':') == string::npos) {
+        ::in_addr addr4;
+        if (::inet_pton(AF_INET, host_addr.c_str(), &addr4) != 1) {
+            return raw_error_result(errc::invalid_argument);
+        }
+
+        return make_ok_result(make_ipv4_socket_address(be32toh(addr4.s_addr), port));
+    }
+
+    auto addr6_str = host_addr.size() >= 2 && host_addr.front() == '[' && host_addr.back() == ']'
+        ? host_addr.substr(1, host_addr.size() - 2)
+        : host_addr;
+
+    uint32_t scope_id = 0;
+    const auto scope_pos = addr6_str.find('%');
+    if (scope_pos != string::npos) {
+        const auto scope_str = addr6_str.substr(scope_pos + 1);
+        if (scope_str.empty() || scope_str.size() > 9 || scope_str.find_first_not_of("0123456789") != string::npos) {
+            return raw_error_result(errc::invalid_argument);
+        }
+
+        scope_id = static_cast<uint32_t>(std::stoul(scope_str));
+        addr6_str.resize(scope_pos);
+    }
+
+    array<uint8_t, 16> addr6;
+    if (::inet_pton(AF_INET6, addr6_str.c_str(), addr6.data()) != 1) {
+        return raw_error_result(errc::invalid_argument);
+    }
+
+    return make_ok_result(make_ipv6_socket_address(addr6, port, scope_id));
+}
+
+
+unique_ptr<socket_address> make_socket_address_copy(socket_address_view addr)
+{
+    return make_unique<inline_socket_address>(addr);
+}
+
+
 result<owned_fd> open_stream_socket(int domain)
 {
     return open_socket(domain, SOCK_STREAM);
@@ -346,6 +418,12 @@ result<owned_fd> open_bound_datagram_socket(socket_address_view addr)
 
 
 result<owned_fd> open_connected_stream_socket(socket_address_view addr)
+{
+    return open_connected_stream_socket(addr, socket_options());
+}
+
+
+result<owned_fd> open_connected_stream_socket(socket_address_view addr, const socket_options &sock_opts)
 {
     auto sock_fd_res = open_stream_socket(addr.addr->sa_family);
     if (!sock_fd_res.is_ok()) {
@@ -354,7 +432,10 @@ result<owned_fd> open_connected_stream_socket(socket_address_view addr)
 
     const auto &sock_fd = sock_fd_res.get_value();
 
-    auto connect_res = connect_socket(*sock_fd, addr);
+    auto opts_res = set_socket_options(*sock_fd, sock_opts);
+    auto connect_res = opts_res.is_ok()
+        ? connect_socket(*sock_fd, addr)
+        : raw_error_result(opts_res);
 
     return connect_res.is_ok()
         ? move(sock_fd_res)
@@ -363,6 +444,13 @@ result<owned_fd> open_connected_stream_socket(socket_address_view addr)
 
 
 result<owned_fd> open_listening_stream_socket(socket_address_view addr, int conn_backlog_size)
+{
+    return open_listening_stream_socket(addr, conn_backlog_size, socket_options());
+}
+
+
+result<owned_fd> open_listening_stream_socket(
+    socket_address_view addr, int conn_backlog_size, const socket_options &sock_opts)
 {
     auto sock_fd_res = open_stream_socket(addr.addr->sa_family);
     if (!sock_fd_res.is_ok()) {
@@ -371,7 +459,10 @@ result<owned_fd> open_listening_stream_socket(socket_address_view addr, int conn
 
     const auto &sock_fd = sock_fd_res.get_value();
 
-    auto bind_res = bind_socket(*sock_fd, addr);
+    auto opts_res = set_socket_options(*sock_fd, sock_opts);
+    auto bind_res = opts_res.is_ok()
+        ? bind_socket(*sock_fd, addr)
+        : raw_error_result(opts_res);
     auto listen_res = bind_res.is_ok()
         ? listen_on_socket(*sock_fd, conn_backlog_size)
         : raw_error_result(bind_res);
@@ -382,14 +473,65 @@ result<owned_fd> open_listening_stream_socket(socket_address_view addr, int conn
 }
 
 
-result<tuple<unique_ptr<socket_address>, string>> receive_datagram_via_socket(int sock_fd, size_t max_data_size)
+result<vector<owned_fd>> open_reuseport_listening_stream_sockets(
+    socket_address_view addr, int conn_backlog_size, size_t sockets_count, bool set_incoming_cpu_hints)
+{
+    vector<owned_fd> sock_fds;
+    unique_ptr<socket_address> bound_addr;
+
+    for (size_t i = 0; i < sockets_count; ++i) {
+        auto sock_fd_res = open_stream_socket(addr.addr->sa_family);
+        if (!sock_fd_res.is_ok()) {
+            return raw_error_result(sock_fd_res);
+        }
+
+        const auto &sock_fd = sock_fd_res.get_value();
+
+        auto opt_res = set_socket_int_option(*sock_fd, SOL_SOCKET, SO_REUSEPORT, 1);
+        if (opt_res.is_ok() && set_incoming_cpu_hints) {
+            opt_res = set_socket_int_option(*sock_fd, SOL_SOCKET, SO_INCOMING_CPU, static_cast<int>(i));
+        }
+
+        auto bind_res = opt_res.is_ok()
+            ? bind_socket(*sock_fd, bound_addr ? bound_addr->get_view() : addr)
+            : raw_error_result(opt_res);
+        auto listen_res = bind_res.is_ok()
+            ? listen_on_socket(*sock_fd, conn_backlog_size)
+            : raw_error_result(bind_res);
+        if (!listen_res.is_ok()) {
+            return raw_error_result(listen_res);
+        }
+
+        if (!bound_addr) {
+            auto bound_addr_res = get_socket_local_address(*sock_fd);
+            if (!bound_addr_res.is_ok()) {
+                return raw_error_result(bound_addr_res);
+            }
+
+            bound_addr = move(bound_addr_res.get_value());
+        }
+
+        sock_fds.push_back(move(sock_fd_res.get_value()));
+    }
+
+    return make_ok_result(move(sock_fds));
+}
+
+
+result<tuple<inline_socket_address, string>> receive_datagram_via_socket(int sock_fd, size_t max_data_size)
 {
     ::sockaddr_storage src_addr;
     ::socklen_t src_addr_size = sizeof(src_addr);
-    auto data_buf = make_unique<char[]>(max_data_size + 1);
+    array<char, max_local_datagram_buffer_size> local_data_buf;
+    unique_ptr<char[]> allocated_data_buf;
+    auto data_buf = local_data_buf.data();
+    if (max_data_size + 1 > local_data_buf.size()) {
+        allocated_data_buf = make_unique<char[]>(max_data_size + 1);
+        data_buf = allocated_data_buf.get();
+    }
 
     ssize_t recv_retval = ::recvfrom(
-        sock_fd, data_buf.get(), max_data_size + 1, 0, reinterpret_cast<sockaddr *>(&src_addr), &src_addr_size);
+        sock_fd, data_buf, max_data_size + 1, 0, reinterpret_cast<sockaddr *>(&src_addr), &src_addr_size);
     if (recv_retval < 0) {
         return make_raw_error_result_from_errno();
     }
@@ -405,8 +547,8 @@ result<tuple<unique_ptr<socket_address>, string>> receive_datagram_via_socket(in
 
     return make_ok_result(
         make_tuple(
-            make_unique<any_socket_address>(src_addr, src_addr_size),
-            string(data_buf.get(), data_size)));
+            inline_socket_address({reinterpret_cast<const ::sockaddr *>(&src_addr), src_addr_size}),
+            string(data_buf, data_size)));
 }
 
 
@@ -438,6 +580,94 @@ result<int> get_socket_int_option(int sock_fd, int level, int opt_name)
 }
 
 
+result<void> set_socket_int_option(int sock_fd, int level, int opt_name, int opt_value)
+{
+    int sockopt_retval = ::setsockopt(sock_fd, level, opt_name, &opt_value, sizeof(opt_value));
+
+    return sockopt_retval == 0
+        ? make_ok_result()
+        : make_raw_error_result_from_errno();
+}
+
+
+result<void> set_socket_options(int sock_fd, const socket_options &sock_opts)
+{
+    const std::initializer_list<tuple<const optional<int> &, int, int>> int_opts = {
+        std::forward_as_tuple(sock_opts.recv_buffer_size, SOL_SOCKET, SO_RCVBUF),
+        std::forward_as_tuple(sock_opts.send_buffer_size, SOL_SOCKET, SO_SNDBUF),
+        std::forward_as_tuple(sock_opts.busy_poll_usecs, SOL_SOCKET, SO_BUSY_POLL),
+        std::forward_as_tuple(sock_opts.tcp_defer_accept_secs, IPPROTO_TCP, TCP_DEFER_ACCEPT),
+        std::forward_as_tuple(sock_opts.tcp_fastopen_queue_size, IPPROTO_TCP, TCP_FASTOPEN),
+    };
+
+    if (sock_opts.tcp_nodelay) {
+        auto opt_res = set_socket_tcp_nodelay(sock_fd, *sock_opts.tcp_nodelay);
+        if (!opt_res.is_ok()) {
+            return opt_res;
+        }
+    }
+
+    if (sock_opts.tcp_quickack) {
+        auto opt_res = set_socket_tcp_quickack(sock_fd, *sock_opts.tcp_quickack);
+        if (!opt_res.is_ok()) {
+            return opt_res;
+        }
+    }
+
+    for (const auto &int_opt : int_opts) {
+        const auto &opt_value = std::get<0>(int_opt);
+        if (opt_value) {
+            auto opt_res = set_socket_int_option(sock_fd, std::get<1>(int_opt), std::get<2>(int_opt), *opt_value);
+            if (!opt_res.is_ok()) {
+                return opt_res;
+            }
+        }
+    }
+
+    return make_ok_result();
+}
+
+
+result<void> set_socket_tcp_nodelay(int sock_fd, bool enabled)
+{
+    return set_socket_int_option(sock_fd, IPPROTO_TCP, TCP_NODELAY, enabled ? 1 : 0);
+}
+
+
+result<void> set_socket_buffer_sizes(int sock_fd, int recv_buffer_size, int send_buffer_size)
+{
+    auto recv_res = set_socket_int_option(sock_fd, SOL_SOCKET, SO_RCVBUF, recv_buffer_size);
+
+    return recv_res.is_ok()
+        ? set_socket_int_option(sock_fd, SOL_SOCKET, SO_SNDBUF, send_buffer_size)
+        : recv_res;
+}
+
+
+result<void> set_socket_tcp_quickack(int sock_fd, bool enabled)
+{
+    return set_socket_int_option(sock_fd, IPPROTO_TCP, TCP_QUICKACK, enabled ? 1 : 0);
+}
+
+
+result<unique_ptr<socket_address>> get_socket_local_address(int sock_fd)
+{
+    ::sockaddr_storage addr;
+    ::socklen_t addr_size = sizeof(addr);
+    if (::getsockname(sock_fd, reinterpret_cast<::sockaddr *>(&addr), &addr_size) != 0) {
+        return make_raw_error_result_from_errno();
+    }
+
+    if (addr_size > sizeof(addr)) {
+        return raw_error_result(errc::bad_address);
+    }
+
+    return make_ok_result(
+        make_unique<inline_socket_address>(
+            socket_address_view{reinterpret_cast<const ::sockaddr *>(&addr), addr_size}));
+}
+
+
 result<string> bind_local_socket_to_auto_abstract_path(int sock_fd)
 {
     auto bind_res = bind_socket(sock_fd, make_local_socket_unnamed_address().get_view());
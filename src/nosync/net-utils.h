@@ -2,13 +2,17 @@
 #ifndef NOSYNC__NET_UTILS_H
 #define NOSYNC__NET_UTILS_H
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <experimental/optional>
 #include <memory>
 #include <nosync/owned-fd.h>
 #include <nosync/result.h>
 #include <nosync/socket-address.h>
 #include <string>
 #include <tuple>
+#include <vector>
 
 
 struct sockaddr;
@@ -17,6 +21,30 @@ struct sockaddr;
 namespace nosync
 {
 
+/*!
+Tuning options of stream sockets, only the options with values are set.
+
+ - tcp_nodelay - TCP_NODELAY (disable Nagle's algorithm),
+ - recv_buffer_size, send_buffer_size - SO_RCVBUF, SO_SNDBUF (in bytes),
+ - tcp_quickack - TCP_QUICKACK (send ACKs immediately),
+ - busy_poll_usecs - SO_BUSY_POLL (busy polling time on blocking receive),
+ - tcp_defer_accept_secs - TCP_DEFER_ACCEPT (for listening sockets, wake up
+acceptor only when data arrives),
+ - tcp_fastopen_queue_size - TCP_FASTOPEN (for listening sockets, max number
+of pending fast open requests).
+*/
+struct socket_options
+{
+    std::experimental::optional<bool> tcp_nodelay;
+    std::experimental::optional<int> recv_buffer_size;
+    std::experimental::optional<int> send_buffer_size;
+    std::experimental::optional<bool> tcp_quickack;
+    std::experimental::optional<int> busy_poll_usecs;
+    std::experimental::optional<int> tcp_defer_accept_secs;
+    std::experimental::optional<int> tcp_fastopen_queue_size;
+};
+
+
 int get_local_socket_domain();
 
 result<std::unique_ptr<socket_address>> make_local_abstract_socket_address(const std::string &abstract_path);
@@ -25,6 +53,21 @@ result<std::unique_ptr<socket_address>> make_local_filesystem_socket_address(con
 std::unique_ptr<socket_address> make_ipv4_socket_address(std::uint32_t host_addr, std::uint16_t port);
 std::unique_ptr<socket_address> make_ipv4_localhost_socket_address(std::uint16_t port);
 
+std::unique_ptr<socket_address> make_ipv6_socket_address(
+    const std::array<std::uint8_t, 16> &host_addr, std::uint16_t port, std::uint32_t scope_id = 0);
+std::unique_ptr<socket_address> make_ipv6_localhost_socket_address(std::uint16_t port);
+
+/*!
+Make IPv4 or IPv6 socket address from numeric host address string (without DNS queries).
+
+IPv6 address may be enclosed in brackets and may have numeric scope id suffix
+("%<id>"). Strings which aren't valid numeric addresses give
+errc::invalid_argument error.
+*/
+result<std::unique_ptr<socket_address>> make_numeric_ip_socket_address(const std::string &host_addr, std::uint16_t port);
+
+std::unique_ptr<socket_address> make_socket_address_copy(socket_address_view addr);
+
 result<owned_fd> open_stream_socket(int domain);
 result<owned_fd> open_datagram_socket(int domain);
 
@@ -32,14 +75,37 @@ result<owned_fd> open_connected_datagram_socket(socket_address_view addr);
 result<owned_fd> open_bound_datagram_socket(socket_address_view addr);
 
 result<owned_fd> open_connected_stream_socket(socket_address_view addr);
+result<owned_fd> open_connected_stream_socket(socket_address_view addr, const socket_options &sock_opts);
 result<owned_fd> open_listening_stream_socket(socket_address_view addr, int conn_backlog_size);
+result<owned_fd> open_listening_stream_socket(
+    socket_address_view addr, int conn_backlog_size, const socket_options &sock_opts);
+
+/*!
+Open several listening stream sockets sharing the same address with SO_REUSEPORT.
+
+The kernel spreads incoming connections among the sockets, so each of them can
+be handled by separate event loop. If the port in the address is zero, all the
+sockets share the port chosen for the first one. If incoming CPU hints are
+requested, socket number i gets SO_INCOMING_CPU option set to i (which makes
+the kernel prefer it for connections processed on that CPU).
+*/
+result<std::vector<owned_fd>> open_reuseport_listening_stream_sockets(
+    socket_address_view addr, int conn_backlog_size, std::size_t sockets_count, bool set_incoming_cpu_hints = false);
 
-result<std::tuple<std::unique_ptr<socket_address>, std::string>> receive_datagram_via_socket(int sock_fd, std::size_t max_data_size);
+result<std::tuple<inline_socket_address, std::string>> receive_datagram_via_socket(int sock_fd, std::size_t max_data_size);
 
 bool is_stream_socket(int sock_fd);
 bool is_datagram_socket(int sock_fd);
 
 result<int> get_socket_int_option(int sock_fd, int level, int opt_name);
+result<void> set_socket_int_option(int sock_fd, int level, int opt_name, int opt_value);
+
+result<void> set_socket_options(int sock_fd, const socket_options &sock_opts);
+result<void> set_socket_tcp_nodelay(int sock_fd, bool enabled);
+result<void> set_socket_buffer_sizes(int sock_fd, int recv_buffer_size, int send_buffer_size);
+result<void> set_socket_tcp_quickack(int sock_fd, bool enabled);
+
+result<std::unique_ptr<socket_address>> get_socket_local_address(int sock_fd);
 
 result<std::string> bind_local_socket_to_auto_abstract_path(int sock_fd);
 
@@ -0,0 +1,447 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#include <algorithm>
+#include <cerrno>
+#include <deque>
+#include <map>
+#include <nosync/eclock.h>
+#include <nosync/event-loop.h>
+#include <nosync/fd-bytes-io.h>
+#include <nosync/memory-utils.h>
+#include <nosync/pooling-socket-connections-bytes-io-requester.h>
+#include <nosync/raw-error-result.h>
+#include <nosync/requests-queue.h>
+#include <nosync/result-handler-utils.h>
+#include <nosync/socket-connections-fd-requester.h>
+#include <nosync/time-utils.h>
+#include <nosync/type-utils.h>
+#include <stdexcept>
+#include <string>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <system_error>
+#include <tuple>
+#include <utility>
+
+namespace ch = std::chrono;
+using std::deque;
+using std::enable_shared_from_this;
+using std::errc;
+using std::get;
+using std::make_shared;
+using std::make_unique;
+using std::map;
+using std::move;
+using std::shared_ptr;
+using std::size_t;
+using std::string;
+using std::tuple;
+using std::unique_ptr;
+using std::weak_ptr;
+
+
+namespace nosync
+{
+
+namespace
+{
+
+class socket_connections_pool;
+
+
+struct pooled_connection
+{
+    pooled_connection(shared_fd &&sock, shared_ptr<bytes_io> &&io);
+
+    shared_fd sock;
+    shared_ptr<bytes_io> io;
+    size_t ongoing_ops_count;
+    bool broken;
+    weak_ptr<socket_connections_pool> abandoning_pool_wptr;
+    string abandoned_dest_key;
+};
+
+
+struct pooled_destination
+{
+    explicit pooled_destination(event_loop &evloop);
+
+    size_t connections_count;
+    deque<tuple<ch::time_point<eclock>, shared_ptr<pooled_connection>>> idle_connections;
+    requests_queue<shared_ptr<socket_address>, shared_ptr<bytes_io>> waiting_requests;
+};
+
+
+class pooled_connection_bytes_io : public bytes_io
+{
+public:
+    pooled_connection_bytes_io(
+        weak_ptr<socket_connections_pool> &&pool_wptr, const string &dest_key, shared_ptr<pooled_connection> &&conn);
+    ~pooled_connection_bytes_io() override;
+
+    void read_some_bytes(size_t max_size, ch::nanoseconds timeout, result_handler<string> &&res_handler) override;
+    void write_bytes(string &&data, result_handler<void> &&res_handler) override;
+
+private:
+    weak_ptr<socket_connections_pool> pool_wptr;
+    string dest_key;
+    shared_ptr<pooled_connection> conn;
+};
+
+
+class socket_connections_pool
+    : public request_handler<shared_ptr<socket_address>, shared_ptr<bytes_io>>,
+    public enable_shared_from_this<socket_connections_pool>
+{
+public:
+    socket_connections_pool(fd_watching_event_loop &evloop, const socket_connections_pool_config &config);
+    ~socket_connections_pool() override;
+
+    void handle_request(
+        shared_ptr<socket_address> &&addr, ch::nanoseconds timeout,
+        result_handler<shared_ptr<bytes_io>> &&res_handler) override;
+
+    void release_connection(const string &dest_key, shared_ptr<pooled_connection> &&conn);
+    void abandon_connection(const string &dest_key, shared_ptr<pooled_connection> &&conn);
+    void drop_connection(const string &dest_key);
+
+private:
+    shared_ptr<bytes_io> make_pooled_connection_bytes_io(const string &dest_key, shared_ptr<pooled_connection> &&conn);
+    shared_ptr<pooled_connection> take_idle_connection(pooled_destination &dest);
+    void open_connection(
+        const string &dest_key, const shared_ptr<socket_address> &addr, ch::nanoseconds timeout,
+        result_handler<shared_ptr<bytes_io>> &&res_handler);
+    void erase_destination_if_unused(const string &dest_key);
+    void schedule_idle_connections_eviction();
+    void evict_idle_connections();
+
+    fd_watching_event_loop &evloop;
+    socket_connections_pool_config config;
+    map<string, unique_ptr<pooled_destination>> destinations;
+    unique_ptr<activity_handle> eviction_task_handle;
+};
+
+
+string make_destination_key(const socket_address &addr)
+{
+    const auto addr_view = addr.get_view();
+
+    return string(reinterpret_cast<const char *>(addr_view.addr), addr_view.addr_size);
+}
+
+
+bool is_idle_connection_reusable(const pooled_connection &conn)
+{
+    char peeked_byte;
+    ssize_t recv_retval = ::recv(*conn.sock, &peeked_byte, sizeof(peeked_byte), MSG_PEEK | MSG_DONTWAIT);
+
+    return recv_retval < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+}
+
+
+void handle_connection_op_result(pooled_connection &conn, bool op_succeeded)
+{
+    --conn.ongoing_ops_count;
+    if (!op_succeeded) {
+        conn.broken = true;
+    }
+}
+
+
+void drop_abandoned_connection_if_idle(pooled_connection &conn);
+
+
+pooled_connection::pooled_connection(shared_fd &&sock, shared_ptr<bytes_io> &&io)
+    : sock(move(sock)), io(move(io)), ongoing_ops_count(0), broken(false), abandoning_pool_wptr(),
+    abandoned_dest_key()
+{
+}
+
+
+pooled_destination::pooled_destination(event_loop &evloop)
+    : connections_count(0), idle_connections(), waiting_requests(evloop)
+{
+}
+
+
+pooled_connection_bytes_io::pooled_connection_bytes_io(
+    weak_ptr<socket_connections_pool> &&pool_wptr, const string &dest_key, shared_ptr<pooled_connection> &&conn)
+    : pool_wptr(move(pool_wptr)), dest_key(dest_key), conn(move(conn))
+{
+}
+
+
+pooled_connection_bytes_io::~pooled_connection_bytes_io()
+{
+    auto pool_ptr = pool_wptr.lock();
+    if (!pool_ptr) {
+        return;
+    }
+
+    if (conn->ongoing_ops_count > 0) {
+        pool_ptr->abandon_connection(dest_key, move(conn));
+    } else if (!conn->broken) {
+        pool_ptr->release_connection(dest_key, move(conn));
+    } else {
+        pool_ptr->drop_connection(dest_key);
+    }
+}
+
+
+void pooled_connection_bytes_io::read_some_bytes(
+    size_t max_size, ch::nanoseconds timeout, result_handler<string> &&res_handler)
+{
+    ++conn->ongoing_ops_count;
+    conn->io->read_some_bytes(
+        max_size, timeout,
+        [conn = conn, res_handler = move(res_handler)](auto res) {
+            handle_connection_op_result(*conn, res.is_ok());
+            res_handler(move(res));
+            drop_abandoned_connection_if_idle(*conn);
+        });
+}
+
+
+void pooled_connection_bytes_io::write_bytes(string &&data, result_handler<void> &&res_handler)
+{
+    ++conn->ongoing_ops_count;
+    conn->io->write_bytes(
+        move(data),
+        [conn = conn, res_handler = move(res_handler)](auto res) {
+            handle_connection_op_result(*conn, res.is_ok());
+            res_handler(move(res));
+            drop_abandoned_connection_if_idle(*conn);
+        });
+}
+
+
+void drop_abandoned_connection_if_idle(pooled_connection &conn)
+{
+    if (conn.ongoing_ops_count > 0) {
+        return;
+    }
+
+    auto pool_ptr = conn.abandoning_pool_wptr.lock();
+    conn.abandoning_pool_wptr.reset();
+    if (pool_ptr) {
+        pool_ptr->drop_connection(conn.abandoned_dest_key);
+    }
+}
+
+
+socket_connections_pool::socket_connections_pool(
+    fd_watching_event_loop &evloop, const socket_connections_pool_config &config)
+    : evloop(evloop), config(config), destinations(), eviction_task_handle()
+{
+}
+
+
+socket_connections_pool::~socket_connections_pool()
+{
+    if (eviction_task_handle && eviction_task_handle->is_enabled()) {
+        eviction_task_handle->disable();
+    }
+}
+
+
+void socket_connections_pool::handle_request(
+    shared_ptr<socket_address> &&addr, ch::nanoseconds timeout, result_handler<shared_ptr<bytes_io>> &&res_handler)
+{
+    const auto dest_key = make_destination_key(*addr);
+
+    auto &dest_ptr = destinations[dest_key];
+    if (!dest_ptr) {
+        dest_ptr = make_unique<pooled_destination>(evloop);
+    }
+
+    auto &dest = *dest_ptr;
+
+    auto idle_conn = take_idle_connection(dest);
+    if (idle_conn) {
+        invoke_result_handler_later(
+            evloop, move(res_handler), make_ok_result(make_pooled_connection_bytes_io(dest_key, move(idle_conn))));
+    } else if (dest.connections_count < config.max_connections_per_destination) {
+        open_connection(dest_key, addr, timeout, move(res_handler));
+    } else {
+        dest.waiting_requests.push_request(
+            move(addr), time_point_sat_add(evloop.get_etime(), timeout), move(res_handler));
+    }
+}
+
+
+void socket_connections_pool::release_connection(const string &dest_key, shared_ptr<pooled_connection> &&conn)
+{
+    auto &dest = *destinations.at(dest_key);
+
+    if (dest.waiting_requests.has_requests()) {
+        if (!is_idle_connection_reusable(*conn)) {
+            drop_connection(dest_key);
+            return;
+        }
+
+        auto req = dest.waiting_requests.pull_next_request();
+        invoke_result_handler_later(
+            evloop, move(get<result_handler<shared_ptr<bytes_io>>>(req)),
+            make_ok_result(make_pooled_connection_bytes_io(dest_key, move(conn))));
+        return;
+    }
+
+    dest.idle_connections.emplace_back(evloop.get_etime(), move(conn));
+    if (!eviction_task_handle || !eviction_task_handle->is_enabled()) {
+        schedule_idle_connections_eviction();
+    }
+}
+
+
+void socket_connections_pool::abandon_connection(const string &dest_key, shared_ptr<pooled_connection> &&conn)
+{
+    conn->broken = true;
+    conn->abandoning_pool_wptr = weak_from_that(this);
+    conn->abandoned_dest_key = dest_key;
+}
+
+
+void socket_connections_pool::drop_connection(const string &dest_key)
+{
+    auto &dest = *destinations.at(dest_key);
+    --dest.connections_count;
+
+    if (dest.waiting_requests.has_requests()) {
+        auto req = dest.waiting_requests.pull_next_request();
+        open_connection(
+            dest_key, get<shared_ptr<socket_address>>(req),
+            std::max(get<ch::time_point<eclock>>(req) - evloop.get_etime(), ch::nanoseconds(0)),
+            move(get<result_handler<shared_ptr<bytes_io>>>(req)));
+    } else {
+        erase_destination_if_unused(dest_key);
+    }
+}
+
+
+shared_ptr<bytes_io> socket_connections_pool::make_pooled_connection_bytes_io(
+    const string &dest_key, shared_ptr<pooled_connection> &&conn)
+{
+    return make_shared<pooled_connection_bytes_io>(weak_from_that(this), dest_key, move(conn));
+}
+
+
+shared_ptr<pooled_connection> socket_connections_pool::take_idle_connection(pooled_destination &dest)
+{
+    while (!dest.idle_connections.empty()) {
+        auto conn = move(get<shared_ptr<pooled_connection>>(dest.idle_connections.back()));
+        dest.idle_connections.pop_back();
+        if (is_idle_connection_reusable(*conn)) {
+            return conn;
+        }
+
+        --dest.connections_count;
+    }
+
+    return nullptr;
+}
+
+
+void socket_connections_pool::open_connection(
+    const string &dest_key, const shared_ptr<socket_address> &addr, ch::nanoseconds timeout,
+    result_handler<shared_ptr<bytes_io>> &&res_handler)
+{
+    ++destinations.at(dest_key)->connections_count;
+
+    request_socket_connection_fd(
+        evloop, addr, timeout,
+        [pool_wptr = weak_from_that(this), dest_key, res_handler = move(res_handler)](auto sock_res) {
+            auto pool_ptr = pool_wptr.lock();
+            if (!pool_ptr) {
+                res_handler(raw_error_result(errc::operation_canceled));
+                return;
+            }
+
+            if (!sock_res.is_ok()) {
+                pool_ptr->drop_connection(dest_key);
+                res_handler(raw_error_result(sock_res));
+                return;
+            }
+
+            auto &sock = sock_res.get_value();
+            auto conn = make_shared<pooled_connection>(
+                make_copy(sock), make_fd_bytes_io(pool_ptr->evloop, make_copy(sock)));
+            res_handler(make_ok_result(pool_ptr->make_pooled_connection_bytes_io(dest_key, move(conn))));
+        });
+}
+
+
+void socket_connections_pool::erase_destination_if_unused(const string &dest_key)
+{
+    auto dest_iter = destinations.find(dest_key);
+    if (dest_iter != destinations.end() && dest_iter->second->connections_count == 0
+        && !dest_iter->second->waiting_requests.has_requests()) {
+        destinations.erase(dest_iter);
+    }
+}
+
+
+void socket_connections_pool::schedule_idle_connections_eviction()
+{
+    if (eviction_task_handle && eviction_task_handle->is_enabled()) {
+        eviction_task_handle->disable();
+    }
+    eviction_task_handle = nullptr;
+
+    auto min_release_time = ch::time_point<eclock>::max();
+    for (const auto &dest : destinations) {
+        const auto &idle_conns = dest.second->idle_connections;
+        if (!idle_conns.empty()) {
+            min_release_time = std::min(min_release_time, get<ch::time_point<eclock>>(idle_conns.front()));
+        }
+    }
+
+    if (min_release_time == ch::time_point<eclock>::max()) {
+        return;
+    }
+
+    eviction_task_handle = evloop.invoke_at(
+        time_point_sat_add(min_release_time, config.idle_timeout),
+        [pool_wptr = weak_from_that(this)]() {
+            auto pool_ptr = pool_wptr.lock();
+            if (pool_ptr) {
+                pool_ptr->evict_idle_connections();
+            }
+        });
+}
+
+
+void socket_connections_pool::evict_idle_connections()
+{
+    const auto now = evloop.get_etime();
+
+    for (auto dest_iter = destinations.begin(); dest_iter != destinations.end();) {
+        auto &dest = *dest_iter->second;
+        while (!dest.idle_connections.empty()
+            && time_point_sat_add(get<ch::time_point<eclock>>(dest.idle_connections.front()), config.idle_timeout) <= now) {
+            dest.idle_connections.pop_front();
+            --dest.connections_count;
+        }
+
+        if (dest.connections_count == 0 && !dest.waiting_requests.has_requests()) {
+            dest_iter = destinations.erase(dest_iter);
+        } else {
+            ++dest_iter;
+        }
+    }
+
+    schedule_idle_connections_eviction();
+}
+
+}
+
+
+shared_ptr<request_handler<shared_ptr<socket_address>, shared_ptr<bytes_io>>> make_pooling_socket_connections_bytes_io_requester(
+    fd_watching_event_loop &evloop, const socket_connections_pool_config &config)
+{
+    if (config.max_connections_per_destination == 0) {
+        throw std::invalid_argument("socket connections pool requires non-zero connections limit");
+    }
+
+    return make_shared<socket_connections_pool>(evloop, config);
+}
+
+}
@@ -0,0 +1,56 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#ifndef NOSYNC__POOLING_SOCKET_CONNECTIONS_BYTES_IO_REQUESTER_H
+#define NOSYNC__POOLING_SOCKET_CONNECTIONS_BYTES_IO_REQUESTER_H
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <nosync/bytes-io.h>
+#include <nosync/fd-watching-event-loop.h>
+#include <nosync/request-handler.h>
+#include <nosync/socket-address.h>
+
+
+namespace nosync
+{
+
+/*!
+Configuration of socket connections pool.
+
+ - max_connections_per_destination - limit of connections (both idle and in
+use) to single address,
+ - idle_timeout - time (in event loop time) after which unused connection is
+closed.
+*/
+struct socket_connections_pool_config
+{
+    std::size_t max_connections_per_destination;
+    std::chrono::nanoseconds idle_timeout;
+};
+
+
+/*!
+Create variant of socket connections bytes_io requester which reuses connections.
+
+Connections are pooled per destination address. When bytes_io returned by the
+requester is destroyed, its connection is put back to the pool, unless any of
+its operations failed (including read timeouts) or was still ongoing (such
+connection still counts towards the limit until its operations finish). Pooled
+connection is checked (for being closed by the peer or having unexpected data
+to read) before being reused, the ones unused for idle_timeout are closed.
+
+When max_connections_per_destination connections to the address exist, requests
+wait (in the order of receipt, up to their timeout) until one of them is
+released or closed (released connections are checked like the idle ones).
+
+The users must read complete responses before releasing connections, as the
+data buffered in bytes_io isn't preserved in the pool. Zero
+max_connections_per_destination is reported with std::invalid_argument
+exception.
+*/
+std::shared_ptr<request_handler<std::shared_ptr<socket_address>, std::shared_ptr<bytes_io>>> make_pooling_socket_connections_bytes_io_requester(
+    fd_watching_event_loop &evloop, const socket_connections_pool_config &config);
+
+}
+
+#endif /* NOSYNC__POOLING_SOCKET_CONNECTIONS_BYTES_IO_REQUESTER_H */
@@ -97,6 +97,10 @@ bool notify_fd_watches_from_pollfd(manual_fd_watcher &fd_watcher, const ::pollfd
         }
     }
 
+    if (normal_return && pollfd_item.events == map_watch_mode_to_poll_event(fd_watch_mode::error)) {
+        normal_return = fd_watcher.notify_watches(pollfd_item.fd, fd_watch_mode::error);
+    }
+
     return normal_return;
 }
 
@@ -23,7 +23,9 @@ template<typename Req, typename Res, std::size_t N>
 class requests_prioritizer : public std::enable_shared_from_this<requests_prioritizer<Req, Res, N>>
 {
 public:
-    requests_prioritizer(event_loop &evloop, std::shared_ptr<request_handler<Req, Res>> &&base_req_handler);
+    requests_prioritizer(
+        event_loop &evloop, const requests_queue_capacity &pending_requests_capacity,
+        std::shared_ptr<request_handler<Req, Res>> &&base_req_handler);
 
     std::array<std::shared_ptr<request_handler<Req, Res>>, N> create_input_request_handlers();
 
@@ -46,12 +48,13 @@ private:
 
 template<typename Req, typename Res, std::size_t N>
 requests_prioritizer<Req, Res, N>::requests_prioritizer(
-    event_loop &evloop, std::shared_ptr<request_handler<Req, Res>> &&base_req_handler)
+    event_loop &evloop, const requests_queue_capacity &pending_requests_capacity,
+    std::shared_ptr<request_handler<Req, Res>> &&base_req_handler)
     : evloop(evloop), base_req_handler(std::move(base_req_handler)), request_handling_ongoing(false),
     queues(
         generate_array<std::shared_ptr<requests_queue<Req, Res>>, N>(
-            [&evloop](auto) {
-                return std::make_shared<requests_queue<Req, Res>>(evloop);
+            [&evloop, &pending_requests_capacity](auto) {
+                return std::make_shared<requests_queue<Req, Res>>(evloop, pending_requests_capacity);
             }))
 {
 }
@@ -139,9 +142,19 @@ void requests_prioritizer<Req, Res, N>::forward_first_pending_request_if_present
 template<typename Req, typename Res, std::size_t N>
 std::array<std::shared_ptr<request_handler<Req, Res>>, N> make_prioritizing_request_handler(
     event_loop &evloop, std::shared_ptr<request_handler<Req, Res>> &&base_req_handler)
+{
+    return make_prioritizing_request_handler<Req, Res, N>(
+        evloop, make_unlimited_requests_queue_capacity(), std::move(base_req_handler));
+}
+
+
+template<typename Req, typename Res, std::size_t N>
+std::array<std::shared_ptr<request_handler<Req, Res>>, N> make_prioritizing_request_handler(
+    event_loop &evloop, const requests_queue_capacity &pending_requests_capacity,
+    std::shared_ptr<request_handler<Req, Res>> &&base_req_handler)
 {
     auto prioritizer = std::make_shared<prioritizing_request_handler_impl::requests_prioritizer<Req, Res, N>>(
-        evloop, std::move(base_req_handler));
+        evloop, pending_requests_capacity, std::move(base_req_handler));
     return prioritizer->create_input_request_handlers();
 }
 
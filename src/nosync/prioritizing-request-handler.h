@@ -6,6 +6,7 @@
 #include <cstddef>
 #include <nosync/event-loop.h>
 #include <nosync/request-handler.h>
+#include <nosync/requests-queue.h>
 #include <memory>
 
 
@@ -33,6 +34,17 @@ template<typename Req, typename Res, std::size_t N = 2>
 std::array<std::shared_ptr<request_handler<Req, Res>>, N> make_prioritizing_request_handler(
     event_loop &evloop, std::shared_ptr<request_handler<Req, Res>> &&base_req_handler);
 
+/*!
+Variant of make_prioritizing_request_handler() with limited queues of pending requests.
+
+Each proxy queues its pending requests in a separate queue with the specified
+capacity.
+*/
+template<typename Req, typename Res, std::size_t N = 2>
+std::array<std::shared_ptr<request_handler<Req, Res>>, N> make_prioritizing_request_handler(
+    event_loop &evloop, const requests_queue_capacity &pending_requests_capacity,
+    std::shared_ptr<request_handler<Req, Res>> &&base_req_handler);
+
 }
 
 #include <nosync/prioritizing-request-handler-impl.h>
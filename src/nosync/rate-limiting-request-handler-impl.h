@@ -0,0 +1,94 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#ifndef NOSYNC__RATE_LIMITING_REQUEST_HANDLER_IMPL_H
+#define NOSYNC__RATE_LIMITING_REQUEST_HANDLER_IMPL_H
+
+#include <algorithm>
+#include <nosync/eclock.h>
+#include <nosync/raw-error-result.h>
+#include <nosync/result-handler.h>
+#include <nosync/time-utils.h>
+#include <utility>
+
+
+namespace nosync
+{
+
+namespace rate_limiting_request_handler_impl
+{
+
+template<typename Req, typename Res>
+class rate_limiting_request_handler : public request_handler<Req, Res>, public std::enable_shared_from_this<rate_limiting_request_handler<Req, Res>>
+{
+public:
+    rate_limiting_request_handler(
+        event_loop &evloop, std::shared_ptr<token_bucket> &&bucket,
+        std::shared_ptr<request_handler<Req, Res>> &&base_handler);
+
+    void handle_request(
+        Req &&request, std::chrono::nanoseconds timeout,
+        result_handler<Res> &&response_handler) override;
+
+private:
+    using std::enable_shared_from_this<rate_limiting_request_handler<Req, Res>>::shared_from_this;
+
+    event_loop &evloop;
+    std::shared_ptr<token_bucket> bucket;
+    std::shared_ptr<request_handler<Req, Res>> base_handler;
+};
+
+
+template<typename Req, typename Res>
+rate_limiting_request_handler<Req, Res>::rate_limiting_request_handler(
+    event_loop &evloop, std::shared_ptr<token_bucket> &&bucket,
+    std::shared_ptr<request_handler<Req, Res>> &&base_handler)
+    : evloop(evloop), bucket(std::move(bucket)), base_handler(std::move(base_handler))
+{
+}
+
+
+template<typename Req, typename Res>
+void rate_limiting_request_handler<Req, Res>::handle_request(
+    Req &&request, std::chrono::nanoseconds timeout,
+    result_handler<Res> &&response_handler)
+{
+    const auto timeout_end = time_point_sat_add(evloop.get_etime(), timeout);
+
+    bucket->acquire_token(
+        timeout_end,
+        [handler = shared_from_this(), request = std::move(request), timeout_end, response_handler = std::move(response_handler)](auto grant_res) mutable {
+            if (!grant_res.is_ok()) {
+                response_handler(raw_error_result(grant_res));
+                return;
+            }
+
+            handler->base_handler->handle_request(
+                std::move(request), std::max(timeout_end - handler->evloop.get_etime(), std::chrono::nanoseconds(0)),
+                std::move(response_handler));
+        });
+}
+
+}
+
+
+template<typename Req, typename Res>
+std::shared_ptr<request_handler<Req, Res>> make_rate_limiting_request_handler(
+    event_loop &evloop, std::shared_ptr<token_bucket> bucket,
+    std::shared_ptr<request_handler<Req, Res>> &&base_handler)
+{
+    return std::make_shared<rate_limiting_request_handler_impl::rate_limiting_request_handler<Req, Res>>(
+        evloop, std::move(bucket), std::move(base_handler));
+}
+
+
+template<typename Req, typename Res>
+std::shared_ptr<request_handler<Req, Res>> make_rate_limiting_request_handler(
+    event_loop &evloop, std::chrono::nanoseconds token_interval, unsigned burst_size,
+    std::shared_ptr<request_handler<Req, Res>> &&base_handler)
+{
+    return make_rate_limiting_request_handler(
+        evloop, make_token_bucket(evloop, token_interval, burst_size), std::move(base_handler));
+}
+
+}
+
+#endif /* NOSYNC__RATE_LIMITING_REQUEST_HANDLER_IMPL_H */
@@ -0,0 +1,40 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#ifndef NOSYNC__RATE_LIMITING_REQUEST_HANDLER_H
+#define NOSYNC__RATE_LIMITING_REQUEST_HANDLER_H
+
+#include <chrono>
+#include <memory>
+#include <nosync/event-loop.h>
+#include <nosync/request-handler.h>
+#include <nosync/token-bucket.h>
+
+
+namespace nosync
+{
+
+/*!
+Create request_handler<> decorator which forwards requests at a rate limited by token bucket.
+
+Each request takes one token from the bucket before it's forwarded to the
+underlying request_handler. The bucket may be shared by multiple decorators to
+limit their total rate. Requests waiting for tokens are timed out when their
+timeout passes, remaining time is passed to the underlying request_handler.
+*/
+template<typename Req, typename Res>
+std::shared_ptr<request_handler<Req, Res>> make_rate_limiting_request_handler(
+    event_loop &evloop, std::shared_ptr<token_bucket> bucket,
+    std::shared_ptr<request_handler<Req, Res>> &&base_handler);
+
+/*!
+Variant of make_rate_limiting_request_handler() with own token bucket created by make_token_bucket().
+*/
+template<typename Req, typename Res>
+std::shared_ptr<request_handler<Req, Res>> make_rate_limiting_request_handler(
+    event_loop &evloop, std::chrono::nanoseconds token_interval, unsigned burst_size,
+    std::shared_ptr<request_handler<Req, Res>> &&base_handler);
+
+}
+
+#include <nosync/rate-limiting-request-handler-impl.h>
+
+#endif /* NOSYNC__RATE_LIMITING_REQUEST_HANDLER_H */
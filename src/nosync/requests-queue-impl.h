@@ -3,10 +3,13 @@
 #define NOSYNC__REQUESTS_QUEUE_IMPL_H
 
 #include <algorithm>
+#include <limits>
 #include <nosync/activity-handle.h>
 #include <nosync/event-loop-utils.h>
 #include <nosync/raw-error-result.h>
+#include <nosync/result-handler-utils.h>
 #include <nosync/result-utils.h>
+#include <nosync/time-utils.h>
 #include <stdexcept>
 #include <system_error>
 #include <utility>
@@ -15,26 +18,22 @@
 namespace nosync
 {
 
-namespace requests_queue_impl
+inline requests_queue_capacity make_unlimited_requests_queue_capacity() noexcept
 {
-
-template<class InputIt, class UnaryOperation>
-auto min_transformed_value(InputIt first, InputIt last, UnaryOperation unary_op) -> decltype(unary_op(*first))
-{
-    auto min_elem_iter = std::min_element(
-        first, last,
-        [&](const auto &lhs, const auto &rhs) {
-            return unary_op(lhs) < unary_op(rhs);
-        });
-    return unary_op(*min_elem_iter);
+    return {std::numeric_limits<std::size_t>::max(), requests_queue_overflow_policy::reject_newest, std::chrono::nanoseconds(0)};
 }
 
+
+template<typename Req, typename Res>
+requests_queue<Req, Res>::requests_queue(event_loop &evloop)
+    : requests_queue(evloop, make_unlimited_requests_queue_capacity())
+{
 }
 
 
 template<typename Req, typename Res>
-requests_queue<Req, Res>::requests_queue(event_loop &evloop)
-    : evloop(evloop)
+requests_queue<Req, Res>::requests_queue(event_loop &evloop, const requests_queue_capacity &capacity)
+    : evloop(evloop), capacity(capacity), requests(), requests_count(0), first_request_seq(0), timeouts_heap()
 {
 }
 
@@ -52,8 +51,10 @@ requests_queue<Req, Res>::~requests_queue()
             [cancel_requests = std::move(requests)]() mutable {
                 for (auto &req : cancel_requests) {
                     auto &res_handler = std::get<result_handler<Res>>(req);
-                    res_handler(raw_error_result(std::errc::operation_canceled));
-                    res_handler = nullptr;
+                    if (res_handler) {
+                        res_handler(raw_error_result(std::errc::operation_canceled));
+                        res_handler = nullptr;
+                    }
                 }
             });
     }
@@ -65,7 +66,19 @@ void requests_queue<Req, Res>::push_request(
     Req &&request, std::chrono::time_point<eclock> timeout_end,
     result_handler<Res> &&res_handler)
 {
-    requests.emplace_back(std::move(request), timeout_end, std::move(res_handler));
+    if (requests_count >= capacity.max_requests && !make_room_for_request()) {
+        reject_request(std::move(res_handler));
+        return;
+    }
+
+    const auto req_seq = first_request_seq + requests.size();
+    requests.emplace_back(std::move(request), timeout_end, std::move(res_handler), timeouts_heap.size());
+
+    ++requests_count;
+
+    timeouts_heap.push_back(req_seq);
+    sift_timeouts_heap_entry_up(timeouts_heap.size() - 1);
+
     reschedule_timeout_task();
 }
 
@@ -77,6 +90,13 @@ bool requests_queue<Req, Res>::has_requests() const
 }
 
 
+template<typename Req, typename Res>
+std::size_t requests_queue<Req, Res>::get_requests_count() const
+{
+    return requests_count;
+}
+
+
 template<typename Req, typename Res>
 std::tuple<Req, std::chrono::time_point<eclock>, result_handler<Res>> requests_queue<Req, Res>::pull_next_request()
 {
@@ -84,40 +104,209 @@ std::tuple<Req, std::chrono::time_point<eclock>, result_handler<Res>> requests_q
         throw std::logic_error("no requests in the queue");
     }
 
-    auto next_request = std::move(requests.front());
+    auto &front_request = requests.front();
+    remove_timeouts_heap_entry(std::get<3>(front_request));
+
+    std::tuple<Req, std::chrono::time_point<eclock>, result_handler<Res>> next_request(
+        std::move(*std::get<0>(front_request)), std::get<1>(front_request), std::move(std::get<2>(front_request)));
     requests.pop_front();
+    ++first_request_seq;
+    --requests_count;
 
+    drop_removed_requests();
     reschedule_timeout_task();
 
     return next_request;
 }
 
 
+template<typename Req, typename Res>
+typename requests_queue<Req, Res>::queued_request &requests_queue<Req, Res>::get_queued_request(std::uint64_t req_seq)
+{
+    return requests[req_seq - first_request_seq];
+}
+
+
+template<typename Req, typename Res>
+bool requests_queue<Req, Res>::is_timeout_earlier(std::uint64_t lhs_req_seq, std::uint64_t rhs_req_seq)
+{
+    const auto lhs_timeout_end = std::get<std::chrono::time_point<eclock>>(get_queued_request(lhs_req_seq));
+    const auto rhs_timeout_end = std::get<std::chrono::time_point<eclock>>(get_queued_request(rhs_req_seq));
+    return lhs_timeout_end < rhs_timeout_end || (lhs_timeout_end == rhs_timeout_end && lhs_req_seq < rhs_req_seq);
+}
+
+
+template<typename Req, typename Res>
+void requests_queue<Req, Res>::place_timeouts_heap_entry(std::size_t heap_pos, std::uint64_t req_seq)
+{
+    timeouts_heap[heap_pos] = req_seq;
+    std::get<3>(get_queued_request(req_seq)) = heap_pos;
+}
+
+
+template<typename Req, typename Res>
+void requests_queue<Req, Res>::sift_timeouts_heap_entry_up(std::size_t heap_pos)
+{
+    const auto req_seq = timeouts_heap[heap_pos];
+    while (heap_pos > 0) {
+        const auto parent_pos = (heap_pos - 1) / 2;
+        if (!is_timeout_earlier(req_seq, timeouts_heap[parent_pos])) {
+            break;
+        }
+        place_timeouts_heap_entry(heap_pos, timeouts_heap[parent_pos]);
+        heap_pos = parent_pos;
+    }
+
+    place_timeouts_heap_entry(heap_pos, req_seq);
+}
+
+
+template<typename Req, typename Res>
+void requests_queue<Req, Res>::sift_timeouts_heap_entry_down(std::size_t heap_pos)
+{
+    const auto req_seq = timeouts_heap[heap_pos];
+    while (true) {
+        auto child_pos = heap_pos * 2 + 1;
+        if (child_pos >= timeouts_heap.size()) {
+            break;
+        }
+        if (child_pos + 1 < timeouts_heap.size() && is_timeout_earlier(timeouts_heap[child_pos + 1], timeouts_heap[child_pos])) {
+            ++child_pos;
+        }
+        if (!is_timeout_earlier(timeouts_heap[child_pos], req_seq)) {
+            break;
+        }
+        place_timeouts_heap_entry(heap_pos, timeouts_heap[child_pos]);
+        heap_pos = child_pos;
+    }
+
+    place_timeouts_heap_entry(heap_pos, req_seq);
+}
+
+
+template<typename Req, typename Res>
+void requests_queue<Req, Res>::remove_timeouts_heap_entry(std::size_t heap_pos)
+{
+    const auto last_req_seq = timeouts_heap.back();
+    timeouts_heap.pop_back();
+    if (heap_pos == timeouts_heap.size()) {
+        return;
+    }
+
+    place_timeouts_heap_entry(heap_pos, last_req_seq);
+    if (heap_pos > 0 && is_timeout_earlier(last_req_seq, timeouts_heap[(heap_pos - 1) / 2])) {
+        sift_timeouts_heap_entry_up(heap_pos);
+    } else {
+        sift_timeouts_heap_entry_down(heap_pos);
+    }
+}
+
+
+template<typename Req, typename Res>
+result_handler<Res> requests_queue<Req, Res>::remove_queued_request(std::uint64_t req_seq)
+{
+    auto &req = get_queued_request(req_seq);
+    remove_timeouts_heap_entry(std::get<3>(req));
+    --requests_count;
+
+    std::get<0>(req) = std::experimental::nullopt;
+
+    auto &req_res_handler = std::get<result_handler<Res>>(req);
+    auto res_handler = std::move(req_res_handler);
+    req_res_handler = nullptr;
+
+    return res_handler;
+}
+
+
+template<typename Req, typename Res>
+void requests_queue<Req, Res>::drop_removed_requests()
+{
+    while (!requests.empty() && !std::get<result_handler<Res>>(requests.front())) {
+        requests.pop_front();
+        ++first_request_seq;
+    }
+
+    if (requests.size() - requests_count > requests_count) {
+        compact_removed_requests();
+    }
+}
+
+
+template<typename Req, typename Res>
+void requests_queue<Req, Res>::compact_removed_requests()
+{
+    std::deque<queued_request> compacted_requests;
+    for (auto &req : requests) {
+        if (std::get<result_handler<Res>>(req)) {
+            timeouts_heap[std::get<3>(req)] = first_request_seq + compacted_requests.size();
+            compacted_requests.push_back(std::move(req));
+        }
+    }
+
+    requests = std::move(compacted_requests);
+}
+
+
+template<typename Req, typename Res>
+bool requests_queue<Req, Res>::make_room_for_request()
+{
+    namespace ch = std::chrono;
+
+    switch (capacity.overflow_policy) {
+    case requests_queue_overflow_policy::reject_newest:
+        break;
+    case requests_queue_overflow_policy::drop_oldest:
+        if (!requests.empty()) {
+            reject_request(std::get<result_handler<Res>>(pull_next_request()));
+        }
+        break;
+    case requests_queue_overflow_policy::drop_expiring: {
+        const auto min_timeout_end = time_point_sat_add(evloop.get_etime(), capacity.est_service_time);
+        while (!timeouts_heap.empty() && std::get<ch::time_point<eclock>>(get_queued_request(timeouts_heap.front())) < min_timeout_end) {
+            reject_request(remove_queued_request(timeouts_heap.front()));
+        }
+        drop_removed_requests();
+        reschedule_timeout_task();
+        break;
+    }
+    }
+
+    return requests_count < capacity.max_requests;
+}
+
+
+template<typename Req, typename Res>
+void requests_queue<Req, Res>::reject_request(result_handler<Res> &&res_handler)
+{
+    invoke_result_handler_later(
+        evloop, std::move(res_handler), raw_error_result(std::errc::resource_unavailable_try_again));
+}
+
+
 template<typename Req, typename Res>
 void requests_queue<Req, Res>::handle_pending_timeouts()
 {
     namespace ch = std::chrono;
 
-    std::deque<result_handler<Res>> timeouting_res_handlers;
+    std::vector<std::tuple<std::uint64_t, result_handler<Res>>> timeouting_reqs;
 
     const auto now = evloop.get_etime();
-    for (auto &req : requests) {
-        if (std::get<ch::time_point<eclock>>(req) <= now) {
-            auto &req_res_handler = std::get<result_handler<Res>>(req);
-            timeouting_res_handlers.push_back(std::move(req_res_handler));
-            req_res_handler = nullptr;
-        }
+    while (!timeouts_heap.empty() && std::get<ch::time_point<eclock>>(get_queued_request(timeouts_heap.front())) <= now) {
+        const auto req_seq = timeouts_heap.front();
+        timeouting_reqs.emplace_back(req_seq, remove_queued_request(req_seq));
     }
 
-    requests.erase(
-        std::remove_if(
-            requests.begin(), requests.end(),
-            [](auto &req) {
-                return !std::get<result_handler<Res>>(req);
-            }),
-        requests.end());
+    drop_removed_requests();
 
-    for (auto &res_handler : timeouting_res_handlers) {
+    std::sort(
+        timeouting_reqs.begin(), timeouting_reqs.end(),
+        [](const auto &lhs, const auto &rhs) {
+            return std::get<std::uint64_t>(lhs) < std::get<std::uint64_t>(rhs);
+        });
+
+    for (auto &req : timeouting_reqs) {
+        auto &res_handler = std::get<result_handler<Res>>(req);
         res_handler(make_timeout_raw_error_result());
         res_handler = nullptr;
     }
@@ -146,11 +335,7 @@ void requests_queue<Req, Res>::reschedule_timeout_task()
         return;
     }
 
-    auto min_timeout_end = requests_queue_impl::min_transformed_value(
-        requests.cbegin(), requests.cend(),
-        [&](const auto &elem) {
-            return std::get<ch::time_point<eclock>>(elem);
-        });
+    const auto min_timeout_end = std::get<ch::time_point<eclock>>(get_queued_request(timeouts_heap.front()));
 
     if (!scheduled_timeout_task || std::get<ch::time_point<eclock>>(*scheduled_timeout_task) != min_timeout_end) {
         disable_timeout_task_if_present();
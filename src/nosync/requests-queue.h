@@ -4,6 +4,7 @@
 
 #include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <deque>
 #include <experimental/optional>
 #include <functional>
@@ -13,11 +14,44 @@
 #include <memory>
 #include <string>
 #include <tuple>
+#include <vector>
 
 
 namespace nosync
 {
 
+/*!
+Policy of handling requests pushed to a requests_queue which is already full.
+
+ - reject_newest - the pushed request is rejected,
+ - drop_oldest - the request at the front of the queue is dropped to make room
+for the pushed one,
+ - drop_expiring - requests which can't be served before their timeout ends
+(i.e. their remaining time is below estimated service time) are dropped, if it
+doesn't make room for the pushed request then it's rejected.
+
+Result handlers of rejected and dropped requests get
+errc::resource_unavailable_try_again error.
+*/
+enum class requests_queue_overflow_policy
+{
+    reject_newest,
+    drop_oldest,
+    drop_expiring,
+};
+
+
+struct requests_queue_capacity
+{
+    std::size_t max_requests;
+    requests_queue_overflow_policy overflow_policy;
+    std::chrono::nanoseconds est_service_time;
+};
+
+
+inline requests_queue_capacity make_unlimited_requests_queue_capacity() noexcept;
+
+
 /*!
 Helper class template for implementing queues of async requests.
 
@@ -28,12 +62,22 @@ same order e.g. to ensure sequential processing, throttling, etc.
 Besides just storing the requests, the class automatically handles timeouts for
 them. If timeout is reached for a request, timeout error is passed to its
 response handler and the request is removed from the queue.
+
+Optionally, the number of requests in the queue can be limited, with the
+requests exceeding the limit handled according to requests_queue_overflow_policy.
+
+Timeouts are tracked with a min-heap of requests indexed by their timeout
+ends, so pushing, pulling and timing out a request takes O(log n) time.
+Requests removed from the middle of the queue (due to timeout or overflow
+policy) are destroyed immediately, and the queue storage is compacted when
+such removed entries outnumber the queued requests.
 */
 template<typename Req, typename Res>
 class requests_queue
 {
 public:
     explicit requests_queue(event_loop &evloop);
+    requests_queue(event_loop &evloop, const requests_queue_capacity &capacity);
     ~requests_queue();
 
     void push_request(
@@ -41,16 +85,34 @@ public:
         result_handler<Res> &&res_handler);
 
     bool has_requests() const;
+    std::size_t get_requests_count() const;
 
     std::tuple<Req, std::chrono::time_point<eclock>, result_handler<Res>> pull_next_request();
 
 private:
+    using queued_request = std::tuple<std::experimental::optional<Req>, std::chrono::time_point<eclock>, result_handler<Res>, std::size_t>;
+
+    queued_request &get_queued_request(std::uint64_t req_seq);
+    bool is_timeout_earlier(std::uint64_t lhs_req_seq, std::uint64_t rhs_req_seq);
+    void place_timeouts_heap_entry(std::size_t heap_pos, std::uint64_t req_seq);
+    void sift_timeouts_heap_entry_up(std::size_t heap_pos);
+    void sift_timeouts_heap_entry_down(std::size_t heap_pos);
+    void remove_timeouts_heap_entry(std::size_t heap_pos);
+    result_handler<Res> remove_queued_request(std::uint64_t req_seq);
+    void drop_removed_requests();
+    void compact_removed_requests();
+    bool make_room_for_request();
+    void reject_request(result_handler<Res> &&res_handler);
     void handle_pending_timeouts();
     void disable_timeout_task_if_present();
     void reschedule_timeout_task();
 
     event_loop &evloop;
-    std::deque<std::tuple<Req, std::chrono::time_point<eclock>, result_handler<Res>>> requests;
+    requests_queue_capacity capacity;
+    std::deque<queued_request> requests;
+    std::size_t requests_count;
+    std::uint64_t first_request_seq;
+    std::vector<std::uint64_t> timeouts_heap;
     std::experimental::optional<std::tuple<std::chrono::time_point<eclock>, std::unique_ptr<activity_handle>>> scheduled_timeout_task;
 };
 
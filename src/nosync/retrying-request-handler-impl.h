@@ -0,0 +1,183 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#ifndef NOSYNC__RETRYING_REQUEST_HANDLER_IMPL_H
+#define NOSYNC__RETRYING_REQUEST_HANDLER_IMPL_H
+
+#include <algorithm>
+#include <nosync/eclock.h>
+#include <nosync/memory-utils.h>
+#include <nosync/time-utils.h>
+#include <random>
+#include <utility>
+
+
+namespace nosync
+{
+
+namespace retrying_request_handler_impl
+{
+
+template<typename Req, typename Res>
+struct retried_request_context
+{
+    retried_request_context(
+        Req &&request, std::chrono::time_point<eclock> timeout_end, result_handler<Res> &&res_handler,
+        std::chrono::nanoseconds next_backoff);
+
+    Req request;
+    std::chrono::time_point<eclock> timeout_end;
+    result_handler<Res> res_handler;
+    std::chrono::nanoseconds next_backoff;
+};
+
+
+template<typename Req, typename Res>
+retried_request_context<Req, Res>::retried_request_context(
+    Req &&request, std::chrono::time_point<eclock> timeout_end, result_handler<Res> &&res_handler,
+    std::chrono::nanoseconds next_backoff)
+    : request(std::move(request)), timeout_end(timeout_end), res_handler(std::move(res_handler)),
+    next_backoff(next_backoff)
+{
+}
+
+
+template<typename Req, typename Res>
+class retrying_request_handler : public request_handler<Req, Res>, public std::enable_shared_from_this<retrying_request_handler<Req, Res>>
+{
+public:
+    retrying_request_handler(
+        event_loop &evloop, const retrying_request_handler_config &config,
+        std::shared_ptr<request_handler<Req, Res>> &&base_req_handler, std::uint_fast32_t random_seed);
+
+    void handle_request(Req &&request, std::chrono::nanoseconds timeout, result_handler<Res> &&res_handler) override;
+
+private:
+    void start_attempt(std::shared_ptr<retried_request_context<Req, Res>> &&ctx);
+    void handle_attempt_result(std::shared_ptr<retried_request_context<Req, Res>> &&ctx, result<Res> &&res);
+    bool is_retryable_error(std::error_code ec) const;
+    std::chrono::nanoseconds draw_retry_delay(std::chrono::nanoseconds backoff);
+
+    event_loop &evloop;
+    retrying_request_handler_config config;
+    std::shared_ptr<request_handler<Req, Res>> base_req_handler;
+    double retry_budget;
+    std::minstd_rand random_engine;
+};
+
+
+template<typename Req, typename Res>
+retrying_request_handler<Req, Res>::retrying_request_handler(
+    event_loop &evloop, const retrying_request_handler_config &config,
+    std::shared_ptr<request_handler<Req, Res>> &&base_req_handler, std::uint_fast32_t random_seed)
+    : evloop(evloop), config(config), base_req_handler(std::move(base_req_handler)),
+    retry_budget(std::min(config.initial_retry_budget, config.max_retry_budget)), random_engine(random_seed)
+{
+}
+
+
+template<typename Req, typename Res>
+void retrying_request_handler<Req, Res>::handle_request(
+    Req &&request, std::chrono::nanoseconds timeout, result_handler<Res> &&res_handler)
+{
+    retry_budget = std::min(retry_budget + config.retry_budget_ratio, config.max_retry_budget);
+
+    start_attempt(
+        std::make_shared<retried_request_context<Req, Res>>(
+            std::move(request), time_point_sat_add(evloop.get_etime(), timeout), std::move(res_handler),
+            config.initial_backoff));
+}
+
+
+template<typename Req, typename Res>
+void retrying_request_handler<Req, Res>::start_attempt(std::shared_ptr<retried_request_context<Req, Res>> &&ctx)
+{
+    auto request = ctx->request;
+    const auto timeout = std::max(ctx->timeout_end - evloop.get_etime(), std::chrono::nanoseconds(0));
+
+    base_req_handler->handle_request(
+        std::move(request), timeout,
+        [req_handler_wptr = weak_from_that(this), ctx = std::move(ctx)](auto res) mutable {
+            auto req_handler_ptr = req_handler_wptr.lock();
+            if (!req_handler_ptr) {
+                return;
+            }
+
+            req_handler_ptr->handle_attempt_result(std::move(ctx), std::move(res));
+        });
+}
+
+
+template<typename Req, typename Res>
+void retrying_request_handler<Req, Res>::handle_attempt_result(
+    std::shared_ptr<retried_request_context<Req, Res>> &&ctx, result<Res> &&res)
+{
+    if (res.is_ok() || !is_retryable_error(res.get_error()) || retry_budget < 1) {
+        ctx->res_handler(std::move(res));
+        return;
+    }
+
+    const auto retry_delay = draw_retry_delay(ctx->next_backoff);
+    const auto retry_time = time_point_sat_add(evloop.get_etime(), retry_delay);
+    if (retry_time >= ctx->timeout_end) {
+        ctx->res_handler(std::move(res));
+        return;
+    }
+
+    retry_budget -= 1;
+    ctx->next_backoff = std::min(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(ctx->next_backoff * config.backoff_multiplier),
+        config.max_backoff);
+
+    evloop.invoke_at(
+        retry_time,
+        [req_handler_wptr = weak_from_that(this), ctx = std::move(ctx)]() mutable {
+            auto req_handler_ptr = req_handler_wptr.lock();
+            if (!req_handler_ptr) {
+                return;
+            }
+
+            req_handler_ptr->start_attempt(std::move(ctx));
+        });
+}
+
+
+template<typename Req, typename Res>
+bool retrying_request_handler<Req, Res>::is_retryable_error(std::error_code ec) const
+{
+    return std::find(config.retryable_errors.begin(), config.retryable_errors.end(), ec)
+        != config.retryable_errors.end();
+}
+
+
+template<typename Req, typename Res>
+std::chrono::nanoseconds retrying_request_handler<Req, Res>::draw_retry_delay(std::chrono::nanoseconds backoff)
+{
+    using nanoseconds_rep = std::chrono::nanoseconds::rep;
+
+    return std::chrono::nanoseconds(
+        std::uniform_int_distribution<nanoseconds_rep>(backoff.count() / 2, backoff.count())(random_engine));
+}
+
+}
+
+
+template<typename Req, typename Res>
+std::shared_ptr<request_handler<Req, Res>> make_retrying_request_handler(
+    event_loop &evloop, const retrying_request_handler_config &config,
+    std::shared_ptr<request_handler<Req, Res>> &&base_req_handler)
+{
+    return make_retrying_request_handler(evloop, config, std::move(base_req_handler), std::random_device()());
+}
+
+
+template<typename Req, typename Res>
+std::shared_ptr<request_handler<Req, Res>> make_retrying_request_handler(
+    event_loop &evloop, const retrying_request_handler_config &config,
+    std::shared_ptr<request_handler<Req, Res>> &&base_req_handler, std::uint_fast32_t random_seed)
+{
+    return std::make_shared<retrying_request_handler_impl::retrying_request_handler<Req, Res>>(
+        evloop, config, std::move(base_req_handler), random_seed);
+}
+
+}
+
+#endif /* NOSYNC__RETRYING_REQUEST_HANDLER_IMPL_H */
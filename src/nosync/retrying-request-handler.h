@@ -0,0 +1,79 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#ifndef NOSYNC__RETRYING_REQUEST_HANDLER_H
+#define NOSYNC__RETRYING_REQUEST_HANDLER_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <nosync/event-loop.h>
+#include <nosync/request-handler.h>
+#include <system_error>
+#include <vector>
+
+
+namespace nosync
+{
+
+/*!
+Configuration of retrying request_handler<> decorator.
+
+ - retryable_errors - error codes for which requests are retried,
+ - initial_backoff - base delay before the first retry,
+ - max_backoff - limit of base delay growth,
+ - backoff_multiplier - factor by which the base delay grows after each retry,
+ - retry_budget_ratio - number of retries allowed per handled request,
+ - max_retry_budget - limit of the number of retries that can be accumulated,
+ - initial_retry_budget - number of retries available right after creation
+(so that failures of the first requests can be retried too).
+*/
+struct retrying_request_handler_config
+{
+    std::vector<std::error_code> retryable_errors;
+    std::chrono::nanoseconds initial_backoff;
+    std::chrono::nanoseconds max_backoff;
+    double backoff_multiplier;
+    double retry_budget_ratio;
+    double max_retry_budget;
+    double initial_retry_budget;
+};
+
+
+/*!
+Create request_handler<> decorator which retries requests failed with selected errors.
+
+A request failed with one of retryable errors is forwarded again to the
+underlying request_handler after backoff delay (in event loop time). The delay
+is chosen randomly from range [base/2, base], where base delay starts at
+initial_backoff and grows exponentially up to max_backoff. Retries never exceed
+the timeout of the original request - if the retry wouldn't start before
+timeout end, the last error is returned instead.
+
+Retries are limited with retry budget, which grows by retry_budget_ratio with
+each handled request (up to max_retry_budget) and is consumed by one with each
+retry, so in case of persistent failures the load on the underlying
+request_handler is increased at most by retry_budget_ratio.
+
+The jitter is drawn with pseudo-random generator seeded with random_seed (if
+not given, std::random_device is used).
+
+After the decorator is destroyed, results of requests still being handled
+(waiting for retry or for response of the underlying request_handler) are
+dropped, i.e. their result handlers are not called.
+
+Req type must be copyable.
+*/
+template<typename Req, typename Res>
+std::shared_ptr<request_handler<Req, Res>> make_retrying_request_handler(
+    event_loop &evloop, const retrying_request_handler_config &config,
+    std::shared_ptr<request_handler<Req, Res>> &&base_req_handler);
+
+template<typename Req, typename Res>
+std::shared_ptr<request_handler<Req, Res>> make_retrying_request_handler(
+    event_loop &evloop, const retrying_request_handler_config &config,
+    std::shared_ptr<request_handler<Req, Res>> &&base_req_handler, std::uint_fast32_t random_seed);
+
+}
+
+#include <nosync/retrying-request-handler-impl.h>
+
+#endif /* NOSYNC__RETRYING_REQUEST_HANDLER_H */
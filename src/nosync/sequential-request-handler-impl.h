@@ -19,7 +19,9 @@ template<typename Req, typename Res>
 class sequential_request_handler : public request_handler<Req, Res>, public std::enable_shared_from_this<sequential_request_handler<Req, Res>>
 {
 public:
-    sequential_request_handler(event_loop &evloop, std::shared_ptr<request_handler<Req, Res>> &&base_req_handler);
+    sequential_request_handler(
+        event_loop &evloop, const requests_queue_capacity &pending_requests_capacity,
+        std::shared_ptr<request_handler<Req, Res>> &&base_req_handler);
 
     void handle_request(Req &&request, std::chrono::nanoseconds timeout, result_handler<Res> &&res_handler) override;
 
@@ -34,8 +36,11 @@ private:
 
 
 template<typename Req, typename Res>
-sequential_request_handler<Req, Res>::sequential_request_handler(event_loop &evloop, std::shared_ptr<request_handler<Req, Res>> &&base_req_handler)
-    : evloop(evloop), base_req_handler(std::move(base_req_handler)), pending_requests(evloop), request_ongoing(false)
+sequential_request_handler<Req, Res>::sequential_request_handler(
+    event_loop &evloop, const requests_queue_capacity &pending_requests_capacity,
+    std::shared_ptr<request_handler<Req, Res>> &&base_req_handler)
+    : evloop(evloop), base_req_handler(std::move(base_req_handler)), pending_requests(evloop, pending_requests_capacity),
+    request_ongoing(false)
 {
 }
 
@@ -85,7 +90,18 @@ template<typename Req, typename Res>
 std::shared_ptr<request_handler<Req, Res>> make_sequential_request_handler(
     event_loop &evloop, std::shared_ptr<request_handler<Req, Res>> &&base_req_handler)
 {
-    return std::make_shared<sequential_request_handler_impl::sequential_request_handler<Req, Res>>(evloop, std::move(base_req_handler));
+    return make_sequential_request_handler(
+        evloop, make_unlimited_requests_queue_capacity(), std::move(base_req_handler));
+}
+
+
+template<typename Req, typename Res>
+std::shared_ptr<request_handler<Req, Res>> make_sequential_request_handler(
+    event_loop &evloop, const requests_queue_capacity &pending_requests_capacity,
+    std::shared_ptr<request_handler<Req, Res>> &&base_req_handler)
+{
+    return std::make_shared<sequential_request_handler_impl::sequential_request_handler<Req, Res>>(
+        evloop, pending_requests_capacity, std::move(base_req_handler));
 }
 
 }
@@ -5,6 +5,7 @@
 #include <memory>
 #include <nosync/event-loop.h>
 #include <nosync/request-handler.h>
+#include <nosync/requests-queue.h>
 
 
 namespace nosync
@@ -14,6 +15,11 @@ template<typename Req, typename Res>
 std::shared_ptr<request_handler<Req, Res>> make_sequential_request_handler(
     event_loop &evloop, std::shared_ptr<request_handler<Req, Res>> &&base_req_handler);
 
+template<typename Req, typename Res>
+std::shared_ptr<request_handler<Req, Res>> make_sequential_request_handler(
+    event_loop &evloop, const requests_queue_capacity &pending_requests_capacity,
+    std::shared_ptr<request_handler<Req, Res>> &&base_req_handler);
+
 }
 
 #include <nosync/sequential-request-handler-impl.h>
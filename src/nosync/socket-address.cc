@@ -0,0 +1,49 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#include <algorithm>
+#include <cstring>
+#include <nosync/socket-address.h>
+#include <sys/socket.h>
+
+using std::size_t;
+
+
+namespace nosync
+{
+
+static_assert(
+    sizeof(::sockaddr_storage) <= inline_socket_address::max_addr_size,
+    "inline socket address storage too small for sockaddr_storage");
+
+
+constexpr size_t inline_socket_address::max_addr_size;
+
+
+inline_socket_address::inline_socket_address() noexcept
+    : addr_bytes(), addr_size(0)
+{
+}
+
+
+inline_socket_address::inline_socket_address(socket_address_view addr) noexcept
+    : addr_bytes(), addr_size(std::min(addr.addr_size, max_addr_size))
+{
+    if (addr_size > 0) {
+        std::memcpy(addr_bytes, addr.addr, addr_size);
+    }
+}
+
+
+int inline_socket_address::get_address_family() const
+{
+    return addr_size >= sizeof(::sa_family_t)
+        ? reinterpret_cast<const ::sockaddr *>(addr_bytes)->sa_family
+        : AF_UNSPEC;
+}
+
+
+socket_address_view inline_socket_address::get_view() const
+{
+    return {reinterpret_cast<const ::sockaddr *>(addr_bytes), addr_size};
+}
+
+}
@@ -30,6 +30,38 @@ protected:
     socket_address() = default;
     socket_address(const socket_address &) = default;
     socket_address(socket_address &&) = default;
+    socket_address &operator=(const socket_address &) = default;
+    socket_address &operator=(socket_address &&) = default;
+};
+
+
+/*!
+Socket address of any family stored inline (without heap allocations).
+
+The object holds a copy of up to max_addr_size bytes of the address it's
+constructed from (which is enough for any address family supported by the
+system), so it can be returned by value from functions receiving addresses
+from the kernel.
+*/
+class inline_socket_address : public socket_address
+{
+public:
+    static constexpr std::size_t max_addr_size = 128;
+
+    inline_socket_address() noexcept;
+    explicit inline_socket_address(socket_address_view addr) noexcept;
+
+    inline_socket_address(const inline_socket_address &) = default;
+    inline_socket_address(inline_socket_address &&) = default;
+    inline_socket_address &operator=(const inline_socket_address &) = default;
+    inline_socket_address &operator=(inline_socket_address &&) = default;
+
+    int get_address_family() const override;
+    socket_address_view get_view() const override;
+
+private:
+    alignas(std::max_align_t) unsigned char addr_bytes[max_addr_size];
+    std::size_t addr_size;
 };
 
 }
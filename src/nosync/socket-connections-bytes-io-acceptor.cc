@@ -2,12 +2,15 @@
 #include <nosync/fd-bytes-io.h>
 #include <nosync/socket-connections-bytes-io-acceptor.h>
 #include <nosync/socket-connections-fd-acceptor.h>
+#include <stdexcept>
 #include <utility>
 
 using std::function;
 using std::move;
 using std::shared_ptr;
+using std::reference_wrapper;
 using std::size_t;
+using std::vector;
 
 
 namespace nosync
@@ -24,4 +27,49 @@ shared_ptr<interface_type> make_socket_connections_bytes_io_acceptor(
         });
 }
 
+
+shared_ptr<interface_type> make_socket_connections_bytes_io_acceptor(
+    fd_watching_event_loop &evloop, owned_fd &&listen_sock_fd, const socket_options &conn_sock_opts,
+    function<void(shared_ptr<bytes_io>)> &&io_handler, size_t read_buffer_size)
+{
+    return make_socket_connections_fd_acceptor(
+        evloop, move(listen_sock_fd), conn_sock_opts,
+        [&evloop, io_handler = move(io_handler), read_buffer_size](auto new_fd) {
+            io_handler(make_fd_bytes_io(evloop, move(new_fd), read_buffer_size));
+        });
+}
+
+
+vector<shared_ptr<interface_type>> make_sharded_socket_connections_bytes_io_acceptors(
+    const vector<reference_wrapper<fd_watching_event_loop>> &evloops, vector<owned_fd> &&listen_sock_fds,
+    function<void(size_t, shared_ptr<bytes_io>)> &&io_handler, size_t read_buffer_size)
+{
+    return make_sharded_socket_connections_bytes_io_acceptors(
+        evloops, move(listen_sock_fds), socket_options{}, move(io_handler), read_buffer_size);
+}
+
+
+vector<shared_ptr<interface_type>> make_sharded_socket_connections_bytes_io_acceptors(
+    const vector<reference_wrapper<fd_watching_event_loop>> &evloops, vector<owned_fd> &&listen_sock_fds,
+    const socket_options &conn_sock_opts, function<void(size_t, shared_ptr<bytes_io>)> &&io_handler,
+    size_t read_buffer_size)
+{
+    if (listen_sock_fds.size() != evloops.size()) {
+        throw std::invalid_argument("number of listening sockets must be equal to number of event loops");
+    }
+
+    vector<shared_ptr<interface_type>> acceptors;
+    for (size_t i = 0; i < evloops.size(); ++i) {
+        acceptors.push_back(
+            make_socket_connections_bytes_io_acceptor(
+                evloops[i], move(listen_sock_fds[i]), conn_sock_opts,
+                [i, io_handler](auto io) {
+                    io_handler(i, move(io));
+                },
+                read_buffer_size));
+    }
+
+    return acceptors;
+}
+
 }
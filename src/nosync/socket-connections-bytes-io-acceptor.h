@@ -2,12 +2,15 @@
 #ifndef NOSYNC__SOCKET_CONNECTIONS_BYTES_IO_ACCEPTOR_H
 #define NOSYNC__SOCKET_CONNECTIONS_BYTES_IO_ACCEPTOR_H
 
+#include <cstddef>
 #include <functional>
 #include <nosync/bytes-io.h>
 #include <nosync/fd-watching-event-loop.h>
 #include <nosync/interface-type.h>
+#include <nosync/net-utils.h>
 #include <nosync/owned-fd.h>
 #include <memory>
+#include <vector>
 
 
 namespace nosync
@@ -18,6 +21,53 @@ std::shared_ptr<interface_type> make_socket_connections_bytes_io_acceptor(
     std::function<void(std::shared_ptr<bytes_io>)> &&io_handler,
     std::size_t read_buffer_size = 8192);
 
+
+/*!
+Variant of make_socket_connections_bytes_io_acceptor which tunes accepted connections.
+
+The options are set on each accepted connection before it's passed to the
+handler. The connections for which it fails are closed without notifying the
+handler (like the ones for which accept() fails), so users interested in such
+failures should use make_full_socket_connections_fd_acceptor() variant taking
+socket_options.
+*/
+std::shared_ptr<interface_type> make_socket_connections_bytes_io_acceptor(
+    fd_watching_event_loop &evloop, owned_fd &&listen_sock_fd, const socket_options &conn_sock_opts,
+    std::function<void(std::shared_ptr<bytes_io>)> &&io_handler,
+    std::size_t read_buffer_size = 8192);
+
+
+/*!
+Create acceptors for listening sockets sharded across event loops.
+
+Listening socket i (e.g. one of opened with
+open_reuseport_listening_stream_sockets()) is handled by event loop i, the
+connections accepted from it are passed to io_handler (a copy of which is kept
+by each of the acceptors) together with the index. The number of sockets must
+be equal to the number of event loops. As acceptors add watches to the event
+loops, the function must be called when it's safe to access all of them (e.g.
+before the loops are started in their threads); each returned acceptor must be
+destroyed in the thread of its event loop.
+*/
+std::vector<std::shared_ptr<interface_type>> make_sharded_socket_connections_bytes_io_acceptors(
+    const std::vector<std::reference_wrapper<fd_watching_event_loop>> &evloops,
+    std::vector<owned_fd> &&listen_sock_fds,
+    std::function<void(std::size_t, std::shared_ptr<bytes_io>)> &&io_handler,
+    std::size_t read_buffer_size = 8192);
+
+
+/*!
+Variant of make_sharded_socket_connections_bytes_io_acceptors which tunes accepted connections.
+
+The options are applied by each of the acceptors like in
+make_socket_connections_bytes_io_acceptor() taking socket_options.
+*/
+std::vector<std::shared_ptr<interface_type>> make_sharded_socket_connections_bytes_io_acceptors(
+    const std::vector<std::reference_wrapper<fd_watching_event_loop>> &evloops,
+    std::vector<owned_fd> &&listen_sock_fds, const socket_options &conn_sock_opts,
+    std::function<void(std::size_t, std::shared_ptr<bytes_io>)> &&io_handler,
+    std::size_t read_buffer_size = 8192);
+
 }
 
 #endif /* NOSYNC__SOCKET_CONNECTIONS_BYTES_IO_ACCEPTOR_H */
@@ -7,6 +7,7 @@
 namespace ch = std::chrono;
 using std::move;
 using std::shared_ptr;
+using std::vector;
 
 
 namespace nosync
@@ -26,6 +27,20 @@ void request_socket_connection_bytes_io(
 }
 
 
+void request_first_socket_connection_bytes_io(
+    fd_watching_event_loop &evloop, const vector<shared_ptr<socket_address>> &addrs,
+    ch::nanoseconds attempt_delay, ch::nanoseconds timeout, result_handler<shared_ptr<bytes_io>> &&res_handler)
+{
+    request_first_socket_connection_fd(
+        evloop, addrs, attempt_delay, timeout,
+        transform_result_handler<shared_fd>(
+            move(res_handler),
+            [&evloop](auto sock) {
+                return make_ok_result(make_fd_bytes_io(evloop, move(sock)));
+            }));
+}
+
+
 shared_ptr<request_handler<shared_ptr<socket_address>, shared_ptr<bytes_io>>> make_socket_connections_bytes_io_requester(
     fd_watching_event_loop &evloop)
 {
@@ -9,6 +9,7 @@
 #include <nosync/request-handler.h>
 #include <nosync/result-handler.h>
 #include <nosync/socket-address.h>
+#include <vector>
 
 
 namespace nosync
@@ -18,6 +19,11 @@ void request_socket_connection_bytes_io(
     fd_watching_event_loop &evloop, const std::shared_ptr<socket_address> &addr,
     std::chrono::nanoseconds timeout, result_handler<std::shared_ptr<bytes_io>> &&res_handler);
 
+void request_first_socket_connection_bytes_io(
+    fd_watching_event_loop &evloop, const std::vector<std::shared_ptr<socket_address>> &addrs,
+    std::chrono::nanoseconds attempt_delay, std::chrono::nanoseconds timeout,
+    result_handler<std::shared_ptr<bytes_io>> &&res_handler);
+
 std::shared_ptr<request_handler<std::shared_ptr<socket_address>, std::shared_ptr<bytes_io>>> make_socket_connections_bytes_io_requester(
     fd_watching_event_loop &evloop);
 
@@ -1,16 +1,24 @@
 // This file is part of libnosync library. See LICENSE file for license details.
+#include <nosync/net-utils.h>
+#include <nosync/raw-error-result.h>
 #include <nosync/result-utils.h>
 #include <nosync/socket-connections-fd-acceptor.h>
+#include <stdexcept>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <system_error>
 #include <utility>
 
 using std::function;
+using std::get;
 using std::make_shared;
+using std::make_tuple;
 using std::move;
 using std::shared_ptr;
+using std::size_t;
+using std::tuple;
 using std::unique_ptr;
+using std::weak_ptr;
 
 
 namespace nosync
@@ -53,6 +61,80 @@ socket_connections_fd_acceptor::~socket_connections_fd_acceptor()
     listen_sock_watch_handle->disable();
 }
 
+
+class draining_socket_connections_fd_acceptor : public interface_type
+{
+public:
+    draining_socket_connections_fd_acceptor(
+        fd_watcher &watcher, owned_fd &&listen_sock_fd, size_t max_accepts_per_notification,
+        result_handler<tuple<shared_fd, unique_ptr<socket_address>>> &&conn_handler);
+    ~draining_socket_connections_fd_acceptor() override;
+
+private:
+    owned_fd listen_sock_fd;
+    shared_ptr<bool> alive_flag;
+    unique_ptr<activity_handle> listen_sock_watch_handle;
+};
+
+
+result<tuple<shared_fd, unique_ptr<socket_address>>> accept_connection_with_peer_address(int listen_sock_fd)
+{
+    ::sockaddr_storage peer_addr;
+    ::socklen_t peer_addr_size = sizeof(peer_addr);
+    int accept_retval = ::accept4(
+        listen_sock_fd, reinterpret_cast<::sockaddr *>(&peer_addr), &peer_addr_size, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (accept_retval < 0) {
+        return make_raw_error_result_from_errno();
+    }
+
+    shared_fd conn_fd(accept_retval);
+    if (peer_addr_size > sizeof(peer_addr)) {
+        return raw_error_result(std::errc::bad_address);
+    }
+
+    return make_ok_result(
+        make_tuple(
+            move(conn_fd),
+            make_socket_address_copy({reinterpret_cast<const ::sockaddr *>(&peer_addr), peer_addr_size})));
+}
+
+
+bool is_accept_queue_empty_error(std::error_code ec)
+{
+    return ec == std::errc::resource_unavailable_try_again || ec == std::errc::operation_would_block;
+}
+
+
+draining_socket_connections_fd_acceptor::draining_socket_connections_fd_acceptor(
+    fd_watcher &watcher, owned_fd &&listen_sock_fd, size_t max_accepts_per_notification,
+    result_handler<tuple<shared_fd, unique_ptr<socket_address>>> &&conn_handler)
+    : listen_sock_fd(move(listen_sock_fd)), alive_flag(make_shared<bool>(true))
+{
+    listen_sock_watch_handle = watcher.add_watch(
+        *this->listen_sock_fd, fd_watch_mode::input,
+        [fd = *this->listen_sock_fd, alive_flag_wptr = weak_ptr<bool>(alive_flag), max_accepts_per_notification,
+                conn_handler = move(conn_handler)]() {
+            for (size_t i = 0; i < max_accepts_per_notification && !alive_flag_wptr.expired(); ++i) {
+                auto conn_res = accept_connection_with_peer_address(fd);
+                if (!conn_res.is_ok() && is_accept_queue_empty_error(conn_res.get_error())) {
+                    break;
+                }
+
+                const bool accept_failed = !conn_res.is_ok();
+                conn_handler(move(conn_res));
+                if (accept_failed) {
+                    break;
+                }
+            }
+        });
+}
+
+
+draining_socket_connections_fd_acceptor::~draining_socket_connections_fd_acceptor()
+{
+    listen_sock_watch_handle->disable();
+}
+
 }
 
 
@@ -75,4 +157,64 @@ shared_ptr<interface_type> make_socket_connections_fd_acceptor(
         });
 }
 
+
+shared_ptr<interface_type> make_full_socket_connections_fd_acceptor(
+    fd_watcher &watcher, owned_fd &&listen_sock_fd, const socket_options &conn_sock_opts,
+    result_handler<shared_fd> &&conn_handler)
+{
+    return make_full_socket_connections_fd_acceptor(
+        watcher, move(listen_sock_fd),
+        [conn_sock_opts, conn_handler = move(conn_handler)](auto conn_res) {
+            if (!conn_res.is_ok()) {
+                conn_handler(move(conn_res));
+                return;
+            }
+
+            auto set_res = set_socket_options(*conn_res.get_value(), conn_sock_opts);
+            conn_handler(set_res.is_ok() ? move(conn_res) : raw_error_result(set_res));
+        });
+}
+
+
+shared_ptr<interface_type> make_socket_connections_fd_acceptor(
+    fd_watcher &watcher, owned_fd &&listen_sock_fd, const socket_options &conn_sock_opts,
+    function<void(shared_fd)> &&conn_handler)
+{
+    return make_full_socket_connections_fd_acceptor(
+        watcher, move(listen_sock_fd), conn_sock_opts,
+        [conn_handler = move(conn_handler)](auto conn_res) {
+            if (conn_res.is_ok()) {
+                conn_handler(move(conn_res.get_value()));
+            }
+        });
+}
+
+
+shared_ptr<interface_type> make_full_draining_socket_connections_fd_acceptor(
+    fd_watcher &watcher, owned_fd &&listen_sock_fd, size_t max_accepts_per_notification,
+    result_handler<tuple<shared_fd, unique_ptr<socket_address>>> &&conn_handler)
+{
+    if (max_accepts_per_notification == 0) {
+        throw std::invalid_argument("max accepts per notification must be positive");
+    }
+
+    return make_shared<draining_socket_connections_fd_acceptor>(
+        watcher, move(listen_sock_fd), max_accepts_per_notification, move(conn_handler));
+}
+
+
+shared_ptr<interface_type> make_draining_socket_connections_fd_acceptor(
+    fd_watcher &watcher, owned_fd &&listen_sock_fd, size_t max_accepts_per_notification,
+    function<void(shared_fd, unique_ptr<socket_address>)> &&conn_handler)
+{
+    return make_full_draining_socket_connections_fd_acceptor(
+        watcher, move(listen_sock_fd), max_accepts_per_notification,
+        [conn_handler = move(conn_handler)](auto conn_res) {
+            if (conn_res.is_ok()) {
+                auto &conn = conn_res.get_value();
+                conn_handler(move(get<shared_fd>(conn)), move(get<unique_ptr<socket_address>>(conn)));
+            }
+        });
+}
+
 }
@@ -2,14 +2,18 @@
 #ifndef NOSYNC__SOCKET_CONNECTIONS_FD_ACCEPTOR_H
 #define NOSYNC__SOCKET_CONNECTIONS_FD_ACCEPTOR_H
 
+#include <cstddef>
 #include <functional>
 #include <nosync/result.h>
 #include <nosync/fd-watcher.h>
 #include <nosync/interface-type.h>
+#include <nosync/net-utils.h>
 #include <nosync/owned-fd.h>
 #include <nosync/result-handler.h>
 #include <nosync/shared-fd.h>
+#include <nosync/socket-address.h>
 #include <memory>
+#include <tuple>
 
 
 namespace nosync
@@ -42,6 +46,53 @@ std::shared_ptr<interface_type> make_socket_connections_fd_acceptor(
     fd_watcher &watcher, owned_fd &&listen_sock_fd,
     std::function<void(shared_fd)> &&conn_handler);
 
+
+/*!
+Variant of make_full_socket_connections_fd_acceptor which tunes accepted connections.
+
+The options are set on each accepted connection before it's passed to the
+handler. If setting them fails, the connection is closed and the handler gets
+the error instead.
+*/
+std::shared_ptr<interface_type> make_full_socket_connections_fd_acceptor(
+    fd_watcher &watcher, owned_fd &&listen_sock_fd, const socket_options &conn_sock_opts,
+    result_handler<shared_fd> &&conn_handler);
+
+
+/*!
+Simplified variant of make_full_socket_connections_fd_acceptor with tuned connections.
+
+The handler function gets only the connections accepted and tuned successfully.
+*/
+std::shared_ptr<interface_type> make_socket_connections_fd_acceptor(
+    fd_watcher &watcher, owned_fd &&listen_sock_fd, const socket_options &conn_sock_opts,
+    std::function<void(shared_fd)> &&conn_handler);
+
+
+/*!
+Draining variant of make_full_socket_connections_fd_acceptor.
+
+On each readiness notification connections are accepted in a loop until there
+are no more pending ones (EAGAIN, which isn't passed to the handler), accept()
+fails in other way or max_accepts_per_notification connections are accepted,
+so bursts of connections are handled in few event loop iterations. Together
+with each connection the handler gets the address of the peer. Zero
+max_accepts_per_notification is reported with std::invalid_argument exception.
+*/
+std::shared_ptr<interface_type> make_full_draining_socket_connections_fd_acceptor(
+    fd_watcher &watcher, owned_fd &&listen_sock_fd, std::size_t max_accepts_per_notification,
+    result_handler<std::tuple<shared_fd, std::unique_ptr<socket_address>>> &&conn_handler);
+
+
+/*!
+Simplified variant of make_full_draining_socket_connections_fd_acceptor.
+
+The handler function gets only successfully accepted connections.
+*/
+std::shared_ptr<interface_type> make_draining_socket_connections_fd_acceptor(
+    fd_watcher &watcher, owned_fd &&listen_sock_fd, std::size_t max_accepts_per_notification,
+    std::function<void(shared_fd, std::unique_ptr<socket_address>)> &&conn_handler);
+
 }
 
 #endif /* NOSYNC__SOCKET_CONNECTIONS_FD_ACCEPTOR_H */
@@ -1,5 +1,10 @@
+#include <cerrno>
+#include <deque>
+#include <map>
+#include <nosync/event-loop-utils.h>
 #include <nosync/fd-watch-utils.h>
 #include <nosync/func-request-handler.h>
+#include <nosync/memory-utils.h>
 #include <nosync/net-utils.h>
 #include <nosync/raw-error-result.h>
 #include <nosync/result-handler-utils.h>
@@ -7,14 +12,25 @@
 #include <nosync/socket-connections-fd-requester.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 namespace ch = std::chrono;
 using nosync::result_handler;
+using std::deque;
+using std::enable_shared_from_this;
+using std::errc;
 using std::error_code;
 using std::generic_category;
+using std::make_shared;
+using std::map;
 using std::move;
 using std::shared_ptr;
+using std::size_t;
+using std::tuple;
+using std::unique_ptr;
+using std::vector;
 
 
 namespace nosync
@@ -23,6 +39,17 @@ namespace nosync
 namespace
 {
 
+result<shared_fd> get_connected_socket_result(shared_fd &&sock)
+{
+    auto sock_err_res = get_socket_int_option(*sock, SOL_SOCKET, SO_ERROR);
+    return sock_err_res.is_ok()
+        ? sock_err_res.get_value() == 0
+            ? make_ok_result(move(sock))
+            : raw_error_result(error_code(sock_err_res.get_value(), generic_category()))
+        : raw_error_result(sock_err_res);
+}
+
+
 void handle_delayed_connect(
     fd_watching_event_loop &evloop, shared_fd sock, ch::nanoseconds timeout,
     result_handler<shared_fd> &&res_handler)
@@ -33,15 +60,198 @@ void handle_delayed_connect(
         transform_result_handler<void>(
             move(res_handler),
             [sock = move(sock)]() mutable {
-                auto sock_err_res = get_socket_int_option(*sock, SOL_SOCKET, SO_ERROR);
-                return sock_err_res.is_ok()
-                    ? sock_err_res.get_value() == 0
-                        ? make_ok_result(move(sock))
-                        : raw_error_result(error_code(sock_err_res.get_value(), generic_category()))
-                    : raw_error_result(sock_err_res);
+                return get_connected_socket_result(move(sock));
             }));
 }
 
+
+class connection_attempts_race : public enable_shared_from_this<connection_attempts_race>
+{
+public:
+    connection_attempts_race(
+        fd_watching_event_loop &evloop, vector<shared_ptr<socket_address>> &&addrs,
+        ch::nanoseconds attempt_delay, result_handler<shared_fd> &&res_handler);
+
+    void start(ch::nanoseconds timeout);
+
+private:
+    void start_next_attempt();
+    void handle_attempt_result(result<shared_fd> &&sock_res);
+    void finish(result<shared_fd> &&res);
+
+    fd_watching_event_loop &evloop;
+    vector<shared_ptr<socket_address>> addrs;
+    size_t next_addr_index;
+    ch::nanoseconds attempt_delay;
+    result_handler<shared_fd> res_handler;
+    map<size_t, tuple<shared_fd, unique_ptr<activity_handle>>> ongoing_attempts;
+    size_t ongoing_immediate_results_count;
+    unique_ptr<activity_handle> next_attempt_task_handle;
+    unique_ptr<activity_handle> timeout_task_handle;
+    error_code last_error;
+};
+
+
+void disable_activity_if_enabled(unique_ptr<activity_handle> &handle)
+{
+    if (handle && handle->is_enabled()) {
+        handle->disable();
+    }
+    handle = nullptr;
+}
+
+
+connection_attempts_race::connection_attempts_race(
+    fd_watching_event_loop &evloop, vector<shared_ptr<socket_address>> &&addrs,
+    ch::nanoseconds attempt_delay, result_handler<shared_fd> &&res_handler)
+    : evloop(evloop), addrs(move(addrs)), next_addr_index(0), attempt_delay(attempt_delay),
+    res_handler(move(res_handler)), ongoing_attempts(), ongoing_immediate_results_count(0),
+    next_attempt_task_handle(), timeout_task_handle(), last_error()
+{
+}
+
+
+void connection_attempts_race::start(ch::nanoseconds timeout)
+{
+    timeout_task_handle = invoke_with_etime_delay(
+        evloop, timeout,
+        [race = shared_from_this()]() {
+            race->timeout_task_handle = nullptr;
+            race->finish(make_timeout_raw_error_result());
+        });
+
+    start_next_attempt();
+}
+
+
+void connection_attempts_race::start_next_attempt()
+{
+    disable_activity_if_enabled(next_attempt_task_handle);
+
+    if (!res_handler || next_addr_index >= addrs.size()) {
+        return;
+    }
+
+    const auto addr_index = next_addr_index;
+    ++next_addr_index;
+
+    if (next_addr_index < addrs.size()) {
+        next_attempt_task_handle = invoke_with_etime_delay(
+            evloop, attempt_delay,
+            [race = shared_from_this()]() {
+                race->next_attempt_task_handle = nullptr;
+                race->start_next_attempt();
+            });
+    }
+
+    auto report_immediate_result = [this](result<shared_fd> &&sock_res) {
+        ++ongoing_immediate_results_count;
+        invoke_later(
+            evloop,
+            [race = shared_from_this(), sock_res = move(sock_res)]() mutable {
+                --race->ongoing_immediate_results_count;
+                race->handle_attempt_result(move(sock_res));
+            });
+    };
+
+    const auto &addr = addrs[addr_index];
+    result<shared_fd> sock_res = open_stream_socket(addr->get_address_family());
+    if (!sock_res.is_ok()) {
+        report_immediate_result(move(sock_res));
+        return;
+    }
+
+    auto &sock = sock_res.get_value();
+
+    auto addr_view = addr->get_view();
+    int connect_retval = ::connect(*sock, addr_view.addr, addr_view.addr_size);
+
+    if (connect_retval == 0) {
+        report_immediate_result(move(sock_res));
+    } else if (errno == EINPROGRESS) {
+        auto sock_fd_no = *sock;
+        auto &attempt = ongoing_attempts[addr_index];
+        std::get<shared_fd>(attempt) = move(sock);
+        std::get<unique_ptr<activity_handle>>(attempt) = evloop.add_watch(
+            sock_fd_no, fd_watch_mode::output,
+            [race_wptr = weak_from_that(this), addr_index]() {
+                auto race_ptr = race_wptr.lock();
+                if (!race_ptr) {
+                    return;
+                }
+
+                auto attempt_iter = race_ptr->ongoing_attempts.find(addr_index);
+                auto &attempt = attempt_iter->second;
+                auto attempt_sock = move(std::get<shared_fd>(attempt));
+                disable_activity_if_enabled(std::get<unique_ptr<activity_handle>>(attempt));
+                race_ptr->ongoing_attempts.erase(attempt_iter);
+
+                race_ptr->handle_attempt_result(get_connected_socket_result(move(attempt_sock)));
+            });
+    } else {
+        report_immediate_result(make_raw_error_result_from_errno());
+    }
+}
+
+
+void connection_attempts_race::handle_attempt_result(result<shared_fd> &&sock_res)
+{
+    if (!res_handler) {
+        return;
+    }
+
+    if (sock_res.is_ok()) {
+        finish(move(sock_res));
+        return;
+    }
+
+    last_error = sock_res.get_error();
+    if (next_addr_index < addrs.size()) {
+        start_next_attempt();
+    } else if (ongoing_attempts.empty() && ongoing_immediate_results_count == 0) {
+        finish(raw_error_result(last_error));
+    }
+}
+
+
+void connection_attempts_race::finish(result<shared_fd> &&res)
+{
+    disable_activity_if_enabled(next_attempt_task_handle);
+    disable_activity_if_enabled(timeout_task_handle);
+    for (auto &attempt : ongoing_attempts) {
+        disable_activity_if_enabled(std::get<unique_ptr<activity_handle>>(attempt.second));
+    }
+    ongoing_attempts.clear();
+
+    auto tmp_res_handler = move(res_handler);
+    res_handler = nullptr;
+    tmp_res_handler(move(res));
+}
+
+
+vector<shared_ptr<socket_address>> interleave_address_families(const vector<shared_ptr<socket_address>> &addrs)
+{
+    const auto first_family = addrs.front()->get_address_family();
+
+    deque<shared_ptr<socket_address>> first_family_addrs;
+    deque<shared_ptr<socket_address>> other_family_addrs;
+    for (const auto &addr : addrs) {
+        (addr->get_address_family() == first_family ? first_family_addrs : other_family_addrs).push_back(addr);
+    }
+
+    vector<shared_ptr<socket_address>> interleaved_addrs;
+    while (!first_family_addrs.empty() || !other_family_addrs.empty()) {
+        for (auto family_addrs : {&first_family_addrs, &other_family_addrs}) {
+            if (!family_addrs->empty()) {
+                interleaved_addrs.push_back(move(family_addrs->front()));
+                family_addrs->pop_front();
+            }
+        }
+    }
+
+    return interleaved_addrs;
+}
+
 }
 
 
@@ -62,9 +272,26 @@ void request_socket_connection_fd(
 
     if (connect_retval == 0) {
         invoke_result_handler_later(evloop, move(res_handler), make_ok_result(move(sock)));
-    } else {
+    } else if (errno == EINPROGRESS) {
         handle_delayed_connect(evloop, move(sock), timeout, move(res_handler));
+    } else {
+        invoke_result_handler_later(evloop, move(res_handler), make_raw_error_result_from_errno());
+    }
+}
+
+
+void request_first_socket_connection_fd(
+    fd_watching_event_loop &evloop, const vector<shared_ptr<socket_address>> &addrs,
+    ch::nanoseconds attempt_delay, ch::nanoseconds timeout, result_handler<shared_fd> &&res_handler)
+{
+    if (addrs.empty()) {
+        invoke_result_handler_later(evloop, move(res_handler), raw_error_result(errc::invalid_argument));
+        return;
     }
+
+    auto race = make_shared<connection_attempts_race>(
+        evloop, interleave_address_families(addrs), attempt_delay, move(res_handler));
+    race->start(timeout);
 }
 
 
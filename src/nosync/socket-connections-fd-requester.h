@@ -8,6 +8,7 @@
 #include <nosync/request-handler.h>
 #include <nosync/shared-fd.h>
 #include <nosync/socket-address.h>
+#include <vector>
 
 
 namespace nosync
@@ -17,6 +18,22 @@ void request_socket_connection_fd(
     fd_watching_event_loop &evloop, const std::shared_ptr<socket_address> &addr,
     std::chrono::nanoseconds timeout, result_handler<shared_fd> &&res_handler);
 
+/*!
+Connect to the first available of several addresses ("happy eyeballs" style).
+
+Connection attempts (asynchronous, with non-blocking connect()) are started
+in the order of the addresses, interleaved by address family (the family of the
+first address goes first), one every attempt_delay or immediately after the
+previous attempt fails. The first established connection is returned (the
+other, still pending attempts are cancelled and their sockets closed at once),
+if all attempts fail, the error of the last one is returned. The whole
+operation is limited by the timeout.
+*/
+void request_first_socket_connection_fd(
+    fd_watching_event_loop &evloop, const std::vector<std::shared_ptr<socket_address>> &addrs,
+    std::chrono::nanoseconds attempt_delay, std::chrono::nanoseconds timeout,
+    result_handler<shared_fd> &&res_handler);
+
 std::shared_ptr<request_handler<std::shared_ptr<socket_address>, shared_fd>> make_socket_connections_fd_requester(
     fd_watching_event_loop &evloop);
 
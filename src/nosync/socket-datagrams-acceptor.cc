@@ -1,21 +1,30 @@
 // This file is part of libnosync library. See LICENSE file for license details.
 #include <nosync/net-utils.h>
+#include <nosync/raw-error-result.h>
 #include <nosync/result-utils.h>
 #include <nosync/socket-datagrams-acceptor.h>
+#include <stdexcept>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <system_error>
 #include <utility>
+#include <vector>
 
+using std::errc;
 using std::function;
 using std::get;
 using std::make_shared;
+using std::make_tuple;
+using std::make_unique;
 using std::move;
 using std::shared_ptr;
 using std::size_t;
 using std::string;
 using std::tuple;
 using std::unique_ptr;
+using std::vector;
+using std::weak_ptr;
 
 
 namespace nosync
@@ -46,7 +55,18 @@ socket_datagrams_acceptor::socket_datagrams_acceptor(
     sock_watch_handle = watcher.add_watch(
         *this->sock_fd, fd_watch_mode::input,
         [fd = *this->sock_fd, datagrams_handler = move(datagrams_handler), max_datagram_size]() {
-            datagrams_handler(receive_datagram_via_socket(fd, max_datagram_size));
+            auto datagram_res = receive_datagram_via_socket(fd, max_datagram_size);
+            if (!datagram_res.is_ok()) {
+                datagrams_handler(raw_error_result(datagram_res));
+                return;
+            }
+
+            auto &datagram = datagram_res.get_value();
+            datagrams_handler(
+                make_ok_result(
+                    make_tuple(
+                        unique_ptr<socket_address>(make_unique<inline_socket_address>(move(get<inline_socket_address>(datagram)))),
+                        move(get<string>(datagram)))));
         });
 }
 
@@ -56,6 +76,101 @@ socket_datagrams_acceptor::~socket_datagrams_acceptor()
     sock_watch_handle->disable();
 }
 
+
+class batched_socket_datagrams_acceptor : public interface_type
+{
+public:
+    batched_socket_datagrams_acceptor(
+        fd_watcher &watcher, owned_fd &&sock_fd, size_t max_datagram_size, size_t max_batch_size,
+        result_handler<vector<tuple<inline_socket_address, string>>> &&datagrams_handler);
+    ~batched_socket_datagrams_acceptor() override;
+
+private:
+    result<vector<tuple<inline_socket_address, string>>> receive_datagrams();
+
+    owned_fd sock_fd;
+    size_t max_datagram_size;
+    bool oversized_datagrams_dropped;
+    shared_ptr<bool> alive_flag;
+    vector<char> data_bufs;
+    vector<::sockaddr_storage> src_addrs;
+    vector<::iovec> data_iovs;
+    vector<::mmsghdr> msg_hdrs;
+    unique_ptr<activity_handle> sock_watch_handle;
+};
+
+
+batched_socket_datagrams_acceptor::batched_socket_datagrams_acceptor(
+    fd_watcher &watcher, owned_fd &&sock_fd, size_t max_datagram_size, size_t max_batch_size,
+    result_handler<vector<tuple<inline_socket_address, string>>> &&datagrams_handler)
+    : sock_fd(move(sock_fd)), max_datagram_size(max_datagram_size), oversized_datagrams_dropped(false),
+    alive_flag(make_shared<bool>(true)), data_bufs(max_batch_size * (max_datagram_size + 1)), src_addrs(max_batch_size), data_iovs(max_batch_size),
+    msg_hdrs(max_batch_size)
+{
+    sock_watch_handle = watcher.add_watch(
+        *this->sock_fd, fd_watch_mode::input,
+        [this, alive_flag_wptr = weak_ptr<bool>(alive_flag), datagrams_handler = move(datagrams_handler)]() {
+            auto datagrams_res = receive_datagrams();
+            const bool oversized_dropped = oversized_datagrams_dropped;
+            oversized_datagrams_dropped = false;
+
+            if (!datagrams_res.is_ok() || !datagrams_res.get_value().empty() || !oversized_dropped) {
+                datagrams_handler(move(datagrams_res));
+            }
+
+            if (oversized_dropped && !alive_flag_wptr.expired()) {
+                datagrams_handler(raw_error_result(errc::message_size));
+            }
+        });
+}
+
+
+batched_socket_datagrams_acceptor::~batched_socket_datagrams_acceptor()
+{
+    sock_watch_handle->disable();
+}
+
+
+result<vector<tuple<inline_socket_address, string>>> batched_socket_datagrams_acceptor::receive_datagrams()
+{
+    const auto data_buf_size = max_datagram_size + 1;
+
+    for (size_t i = 0; i < msg_hdrs.size(); ++i) {
+        data_iovs[i] = {&data_bufs[i * data_buf_size], data_buf_size};
+        msg_hdrs[i] = {};
+        msg_hdrs[i].msg_hdr.msg_name = &src_addrs[i];
+        msg_hdrs[i].msg_hdr.msg_namelen = sizeof(src_addrs[i]);
+        msg_hdrs[i].msg_hdr.msg_iov = &data_iovs[i];
+        msg_hdrs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int recv_retval = ::recvmmsg(*sock_fd, msg_hdrs.data(), msg_hdrs.size(), 0, nullptr);
+    if (recv_retval < 0) {
+        return make_raw_error_result_from_errno();
+    }
+
+    vector<tuple<inline_socket_address, string>> datagrams;
+    datagrams.reserve(recv_retval);
+    for (size_t i = 0; i < static_cast<size_t>(recv_retval); ++i) {
+        const auto &msg_hdr = msg_hdrs[i].msg_hdr;
+        const auto data_size = static_cast<size_t>(msg_hdrs[i].msg_len);
+        if (data_size > max_datagram_size || (msg_hdr.msg_flags & MSG_TRUNC) != 0) {
+            oversized_datagrams_dropped = true;
+            continue;
+        }
+
+        if (msg_hdr.msg_namelen > sizeof(src_addrs[i])) {
+            continue;
+        }
+
+        datagrams.emplace_back(
+            inline_socket_address({reinterpret_cast<const ::sockaddr *>(&src_addrs[i]), msg_hdr.msg_namelen}),
+            string(&data_bufs[i * data_buf_size], data_size));
+    }
+
+    return make_ok_result(move(datagrams));
+}
+
 }
 
 
@@ -83,4 +198,31 @@ shared_ptr<interface_type> make_socket_datagrams_acceptor(
         });
 }
 
+
+shared_ptr<interface_type> make_full_batched_socket_datagrams_acceptor(
+    fd_watcher &watcher, owned_fd &&sock_fd, size_t max_datagram_size, size_t max_batch_size,
+    result_handler<vector<tuple<inline_socket_address, string>>> &&datagrams_handler)
+{
+    if (max_batch_size == 0) {
+        throw std::invalid_argument("max batch size must be positive");
+    }
+
+    return make_shared<batched_socket_datagrams_acceptor>(
+        watcher, move(sock_fd), max_datagram_size, max_batch_size, move(datagrams_handler));
+}
+
+
+shared_ptr<interface_type> make_batched_socket_datagrams_acceptor(
+    fd_watcher &watcher, owned_fd &&sock_fd, size_t max_datagram_size, size_t max_batch_size,
+    function<void(vector<tuple<inline_socket_address, string>>)> &&datagrams_handler)
+{
+    return make_full_batched_socket_datagrams_acceptor(
+        watcher, move(sock_fd), max_datagram_size, max_batch_size,
+        [datagrams_handler = move(datagrams_handler)](auto datagrams_res) {
+            if (datagrams_res.is_ok() && !datagrams_res.get_value().empty()) {
+                datagrams_handler(move(datagrams_res.get_value()));
+            }
+        });
+}
+
 }
@@ -13,6 +13,7 @@
 #include <memory>
 #include <string>
 #include <tuple>
+#include <vector>
 
 
 namespace nosync
@@ -43,6 +44,34 @@ std::shared_ptr<interface_type> make_socket_datagrams_acceptor(
     fd_watcher &watcher, owned_fd &&sock_fd, std::size_t max_datagram_size,
     std::function<void(std::unique_ptr<socket_address>, std::string)> &&datagrams_handler);
 
+
+/*!
+Batched variant of make_full_socket_datagrams_acceptor.
+
+On each readiness notification up to max_batch_size datagrams are received
+with single recvmmsg() call (into receive buffers allocated once and reused for
+all calls) and passed to the handler together, in the order of receipt. Source
+addresses are stored inline, so no allocations are made for them.
+Datagrams longer than max_datagram_size are dropped, and after the batch they
+came with (which is skipped if it's empty) the handler gets
+std::errc::message_size error. Zero max_batch_size is reported with
+std::invalid_argument exception.
+*/
+std::shared_ptr<interface_type> make_full_batched_socket_datagrams_acceptor(
+    fd_watcher &watcher, owned_fd &&sock_fd, std::size_t max_datagram_size, std::size_t max_batch_size,
+    result_handler<std::vector<std::tuple<inline_socket_address, std::string>>> &&datagrams_handler);
+
+
+/*!
+Simplified variant of make_full_batched_socket_datagrams_acceptor.
+
+Failures from recvmmsg() (and oversized datagrams) are ignored, the handler
+function gets only non-empty batches of datagrams.
+*/
+std::shared_ptr<interface_type> make_batched_socket_datagrams_acceptor(
+    fd_watcher &watcher, owned_fd &&sock_fd, std::size_t max_datagram_size, std::size_t max_batch_size,
+    std::function<void(std::vector<std::tuple<inline_socket_address, std::string>>)> &&datagrams_handler);
+
 }
 
 #endif /* NOSYNC__SOCKET_DATAGRAMS_ACCEPTOR_H */
@@ -1,18 +1,29 @@
+#include <algorithm>
+#include <cerrno>
+#include <deque>
 #include <experimental/optional>
 #include <nosync/const-bytes-reader.h>
 #include <nosync/event-loop.h>
-#include <nosync/fd-bytes-writer.h>
 #include <nosync/func-bytes-writer.h>
+#include <nosync/memory-utils.h>
 #include <nosync/net-utils.h>
 #include <nosync/raw-error-result.h>
 #include <nosync/reader-writer-bytes-io.h>
 #include <nosync/result-handler-utils.h>
-#include <nosync/socket-datagrams-acceptor.h>
+#include <nosync/result-utils.h>
+#include <nosync/shared-fd.h>
 #include <nosync/socket-datagrams-responding-acceptor.h>
+#include <nosync/type-utils.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
 #include <system_error>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 namespace ch = std::chrono;
+using std::deque;
+using std::enable_shared_from_this;
 using std::errc;
 using std::error_code;
 using std::experimental::nullopt;
@@ -25,7 +36,9 @@ using std::move;
 using std::shared_ptr;
 using std::size_t;
 using std::string;
+using std::tuple;
 using std::unique_ptr;
+using std::vector;
 
 
 namespace nosync
@@ -75,37 +88,169 @@ void failed_recv_bytes_io::write_bytes(string &&, result_handler<void> &&res_han
 }
 
 
-shared_ptr<bytes_writer> make_datagram_writer(fd_watching_event_loop &evloop, shared_ptr<socket_address> &&dest_address)
+class datagram_responses_sender : public enable_shared_from_this<datagram_responses_sender>
 {
-    return make_func_bytes_writer(
-        [&evloop, dest_address = move(dest_address)](auto data, auto res_handler) {
-            auto sock_fd_res = open_connected_datagram_socket(dest_address->get_view());
-            if (sock_fd_res.is_ok()) {
-                auto writer = make_fd_bytes_writer(evloop, move(sock_fd_res.get_value()));
-                writer->write_bytes(move(data), move(res_handler));
-            } else {
-                invoke_result_handler_later(evloop, move(res_handler), raw_error_result(sock_fd_res));
+public:
+    datagram_responses_sender(fd_watcher &watcher, shared_fd &&sock_fd);
+    ~datagram_responses_sender();
+
+    void send_response(shared_ptr<socket_address> &&dest_address, string &&data, result_handler<void> &&res_handler);
+
+private:
+    void handle_output_ready();
+    int send_pending_responses_batch();
+
+    fd_watcher &watcher;
+    shared_fd sock_fd;
+    deque<tuple<shared_ptr<socket_address>, string, result_handler<void>>> pending_responses;
+    vector<::iovec> data_iovs;
+    vector<::mmsghdr> msg_hdrs;
+    unique_ptr<activity_handle> output_watch_handle;
+};
+
+
+class socket_datagrams_responding_acceptor : public interface_type
+{
+public:
+    socket_datagrams_responding_acceptor(
+        fd_watching_event_loop &evloop, shared_fd &&sock_fd, size_t max_request_datagram_size,
+        function<void(shared_ptr<bytes_io> &&)> &&datagrams_processor);
+    ~socket_datagrams_responding_acceptor() override;
+
+private:
+    shared_fd sock_fd;
+    unique_ptr<activity_handle> sock_watch_handle;
+};
+
+
+datagram_responses_sender::datagram_responses_sender(fd_watcher &watcher, shared_fd &&sock_fd)
+    : watcher(watcher), sock_fd(move(sock_fd)), pending_responses(), data_iovs(), msg_hdrs(), output_watch_handle()
+{
+}
+
+
+datagram_responses_sender::~datagram_responses_sender()
+{
+    if (output_watch_handle) {
+        output_watch_handle->disable();
+    }
+}
+
+
+void datagram_responses_sender::send_response(
+    shared_ptr<socket_address> &&dest_address, string &&data, result_handler<void> &&res_handler)
+{
+    pending_responses.emplace_back(move(dest_address), move(data), move(res_handler));
+
+    if (!output_watch_handle) {
+        output_watch_handle = watcher.add_watch(
+            *sock_fd, fd_watch_mode::output,
+            [sender_wptr = weak_from_that(this)]() {
+                auto sender_ptr = sender_wptr.lock();
+                if (sender_ptr) {
+                    sender_ptr->handle_output_ready();
+                }
+            });
+    }
+}
+
+
+void datagram_responses_sender::handle_output_ready()
+{
+    while (!pending_responses.empty()) {
+        int send_retval = send_pending_responses_batch();
+        if (send_retval < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return;
             }
-        });
+
+            auto res_handler = move(get<result_handler<void>>(pending_responses.front()));
+            pending_responses.pop_front();
+            res_handler(make_raw_error_result_from_errno());
+            continue;
+        }
+
+        for (int i = 0; i < send_retval; ++i) {
+            auto res_handler = move(get<result_handler<void>>(pending_responses.front()));
+            pending_responses.pop_front();
+            res_handler(make_ok_result());
+        }
+    }
+
+    output_watch_handle->disable();
+    output_watch_handle = nullptr;
 }
 
+
+int datagram_responses_sender::send_pending_responses_batch()
+{
+    const auto batch_size = std::min<size_t>(pending_responses.size(), UIO_MAXIOV);
+    data_iovs.resize(batch_size);
+    msg_hdrs.resize(batch_size);
+
+    for (size_t i = 0; i < batch_size; ++i) {
+        auto &data = get<string>(pending_responses[i]);
+        const auto dest_addr_view = get<shared_ptr<socket_address>>(pending_responses[i])->get_view();
+
+        data_iovs[i] = {&data[0], data.size()};
+        msg_hdrs[i] = {};
+        msg_hdrs[i].msg_hdr.msg_name = const_cast<::sockaddr *>(dest_addr_view.addr);
+        msg_hdrs[i].msg_hdr.msg_namelen = dest_addr_view.addr_size;
+        msg_hdrs[i].msg_hdr.msg_iov = &data_iovs[i];
+        msg_hdrs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    return ::sendmmsg(*sock_fd, msg_hdrs.data(), batch_size, MSG_NOSIGNAL);
 }
 
 
-shared_ptr<interface_type> make_socket_datagrams_responding_acceptor(
-    fd_watching_event_loop &evloop, owned_fd &&sock_fd, size_t max_request_datagram_size,
+shared_ptr<bytes_writer> make_datagram_writer(
+    shared_ptr<datagram_responses_sender> sender, shared_ptr<socket_address> &&dest_address)
+{
+    return make_func_bytes_writer(
+        [sender = move(sender), dest_address = move(dest_address)](auto data, auto res_handler) {
+            sender->send_response(make_copy(dest_address), move(data), move(res_handler));
+        });
+}
+
+
+socket_datagrams_responding_acceptor::socket_datagrams_responding_acceptor(
+    fd_watching_event_loop &evloop, shared_fd &&sock_fd, size_t max_request_datagram_size,
     function<void(shared_ptr<bytes_io> &&)> &&datagrams_processor)
+    : sock_fd(move(sock_fd))
 {
-    return make_full_socket_datagrams_acceptor(
-        evloop, move(sock_fd), max_request_datagram_size,
-        [&evloop, datagrams_processor = move(datagrams_processor)](auto recv_res) {
+    auto sender = make_shared<datagram_responses_sender>(evloop, make_copy(this->sock_fd));
+
+    sock_watch_handle = evloop.add_watch(
+        *this->sock_fd, fd_watch_mode::input,
+        [&evloop, fd = *this->sock_fd, max_request_datagram_size, sender = move(sender),
+                datagrams_processor = move(datagrams_processor)]() {
+            auto recv_res = receive_datagram_via_socket(fd, max_request_datagram_size);
             datagrams_processor(
                 recv_res.is_ok()
                     ? make_reader_writer_bytes_io(
                         make_const_bytes_reader(evloop, move(get<string>(recv_res.get_value()))),
-                        make_datagram_writer(evloop, move(get<unique_ptr<socket_address>>(recv_res.get_value()))))
+                        make_datagram_writer(
+                            sender, make_shared<inline_socket_address>(move(get<inline_socket_address>(recv_res.get_value())))))
                     : make_shared<failed_recv_bytes_io>(evloop, recv_res.get_error()));
         });
 }
 
+
+socket_datagrams_responding_acceptor::~socket_datagrams_responding_acceptor()
+{
+    sock_watch_handle->disable();
+}
+
+}
+
+
+shared_ptr<interface_type> make_socket_datagrams_responding_acceptor(
+    fd_watching_event_loop &evloop, owned_fd &&sock_fd, size_t max_request_datagram_size,
+    function<void(shared_ptr<bytes_io> &&)> &&datagrams_processor)
+{
+    return make_shared<socket_datagrams_responding_acceptor>(
+        evloop, move(sock_fd), max_request_datagram_size, move(datagrams_processor));
+}
+
 }
@@ -15,6 +15,15 @@
 namespace nosync
 {
 
+/*!
+Take ownership of bound datagram socket and process incoming datagrams as requests.
+
+Each received datagram is passed to the processor as bytes_io, which reads the
+datagram content and sends written data (each write as separate datagram) back
+to the sender. Responses are sent via the same socket (so they come from the
+address the requests were sent to), the ones written during the same event
+loop iteration are sent together with single sendmmsg() call.
+*/
 std::shared_ptr<interface_type> make_socket_datagrams_responding_acceptor(
     fd_watching_event_loop &evloop, owned_fd &&sock_fd, std::size_t max_request_datagram_size,
     std::function<void(std::shared_ptr<bytes_io> &&)> &&datagrams_processor);
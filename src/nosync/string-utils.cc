@@ -9,6 +9,8 @@
 namespace nosync
 {
 
+using std::experimental::nullopt;
+using std::experimental::optional;
 using std::experimental::string_view;
 using std::invalid_argument;
 using std::isprint;
@@ -31,18 +33,12 @@ constexpr char number_to_hex_digit(unsigned value) noexcept
 
 unsigned number_from_hex_digit(char hex_digit)
 {
-    unsigned digit_value;
-    if (hex_digit >= '0' && hex_digit <= '9') {
-        digit_value = hex_digit - '0';
-    } else if (hex_digit >= 'A' && hex_digit <= 'F') {
-        digit_value = hex_digit - 'A' + 10;
-    } else if (hex_digit >= 'a' && hex_digit <= 'f') {
-        digit_value = hex_digit - 'a' + 10;
-    } else {
+    auto digit_value = try_number_from_hex_digit(hex_digit);
+    if (!digit_value) {
         throw invalid_argument("illegal hex digit: " + string(1, hex_digit));
     }
 
-    return digit_value;
+    return *digit_value;
 }
 
 
@@ -100,6 +96,20 @@ string bytes_to_hex_string(string_view bytes)
 }
 
 
+optional<unsigned> try_number_from_hex_digit(char hex_digit) noexcept
+{
+    if (hex_digit >= '0' && hex_digit <= '9') {
+        return hex_digit - '0';
+    } else if (hex_digit >= 'A' && hex_digit <= 'F') {
+        return hex_digit - 'A' + 10;
+    } else if (hex_digit >= 'a' && hex_digit <= 'f') {
+        return hex_digit - 'a' + 10;
+    } else {
+        return nullopt;
+    }
+}
+
+
 string bytes_from_hex_string(string_view hex_string)
 {
     if (hex_string.size() % 2 != 0) {
@@ -3,6 +3,7 @@
 #define NOSYNC__STRING_UTILS_H
 
 #include <array>
+#include <experimental/optional>
 #include <experimental/string_view>
 #include <string>
 
@@ -13,6 +14,8 @@ namespace nosync
 std::string bytes_to_hex_string(std::experimental::string_view bytes);
 std::string bytes_from_hex_string(std::experimental::string_view hex_string);
 
+std::experimental::optional<unsigned> try_number_from_hex_digit(char hex_digit) noexcept;
+
 template<typename T>
 constexpr std::array<char, sizeof(T) * 2> number_to_hex_digits_array(T value) noexcept;
 
@@ -0,0 +1,129 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#include <algorithm>
+#include <nosync/memory-utils.h>
+#include <nosync/requests-queue.h>
+#include <nosync/token-bucket.h>
+#include <stdexcept>
+#include <utility>
+
+namespace ch = std::chrono;
+using std::enable_shared_from_this;
+using std::get;
+using std::invalid_argument;
+using std::make_shared;
+using std::move;
+using std::nullptr_t;
+using std::shared_ptr;
+using std::unique_ptr;
+
+
+namespace nosync
+{
+
+namespace
+{
+
+class gcra_token_bucket : public token_bucket, public enable_shared_from_this<gcra_token_bucket>
+{
+public:
+    gcra_token_bucket(event_loop &evloop, ch::nanoseconds token_interval, unsigned burst_size);
+    ~gcra_token_bucket() override;
+
+    void acquire_token(ch::time_point<eclock> timeout_end, result_handler<void> &&grant_handler) override;
+
+private:
+    bool try_take_token();
+    void grant_waiting_requests();
+    void schedule_grant_task_if_needed();
+
+    event_loop &evloop;
+    ch::nanoseconds token_interval;
+    ch::nanoseconds burst_tolerance;
+    ch::time_point<eclock> theoretical_arrival_time;
+    requests_queue<nullptr_t, void> waiting_requests;
+    unique_ptr<activity_handle> grant_task_handle;
+};
+
+
+gcra_token_bucket::gcra_token_bucket(event_loop &evloop, ch::nanoseconds token_interval, unsigned burst_size)
+    : evloop(evloop), token_interval(token_interval), burst_tolerance(token_interval * (burst_size - 1)),
+    theoretical_arrival_time(ch::time_point<eclock>::min()), waiting_requests(evloop), grant_task_handle()
+{
+}
+
+
+gcra_token_bucket::~gcra_token_bucket()
+{
+    if (grant_task_handle) {
+        grant_task_handle->disable();
+    }
+}
+
+
+void gcra_token_bucket::acquire_token(ch::time_point<eclock> timeout_end, result_handler<void> &&grant_handler)
+{
+    if (!waiting_requests.has_requests() && try_take_token()) {
+        grant_handler(make_ok_result());
+        return;
+    }
+
+    waiting_requests.push_request(nullptr, timeout_end, move(grant_handler));
+    schedule_grant_task_if_needed();
+}
+
+
+bool gcra_token_bucket::try_take_token()
+{
+    const auto now = evloop.get_etime();
+    const auto arrival_time = std::max(theoretical_arrival_time, now);
+    if (arrival_time - now > burst_tolerance) {
+        return false;
+    }
+
+    theoretical_arrival_time = arrival_time + token_interval;
+    return true;
+}
+
+
+void gcra_token_bucket::grant_waiting_requests()
+{
+    while (waiting_requests.has_requests() && try_take_token()) {
+        auto grant_handler = get<result_handler<void>>(waiting_requests.pull_next_request());
+        grant_handler(make_ok_result());
+    }
+
+    schedule_grant_task_if_needed();
+}
+
+
+void gcra_token_bucket::schedule_grant_task_if_needed()
+{
+    if (grant_task_handle || !waiting_requests.has_requests()) {
+        return;
+    }
+
+    grant_task_handle = evloop.invoke_at(
+        std::max(theoretical_arrival_time, evloop.get_etime()) - burst_tolerance,
+        [bucket_wptr = weak_from_that(this)]() {
+            auto bucket_ptr = bucket_wptr.lock();
+            if (bucket_ptr) {
+                bucket_ptr->grant_task_handle = nullptr;
+                bucket_ptr->grant_waiting_requests();
+            }
+        });
+}
+
+}
+
+
+shared_ptr<token_bucket> make_token_bucket(
+    event_loop &evloop, ch::nanoseconds token_interval, unsigned burst_size)
+{
+    if (burst_size == 0) {
+        throw invalid_argument("token bucket burst size must be positive");
+    }
+
+    return make_shared<gcra_token_bucket>(evloop, token_interval, burst_size);
+}
+
+}
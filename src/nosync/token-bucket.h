@@ -0,0 +1,45 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#ifndef NOSYNC__TOKEN_BUCKET_H
+#define NOSYNC__TOKEN_BUCKET_H
+
+#include <chrono>
+#include <nosync/eclock.h>
+#include <nosync/event-loop.h>
+#include <nosync/interface-type.h>
+#include <nosync/result-handler.h>
+#include <memory>
+
+
+namespace nosync
+{
+
+/*!
+Interface for rate limiting based on "token bucket" algorithm.
+
+Each call to acquire_token() takes a single token from the bucket. When the
+bucket is empty, the call waits (in a queue shared by all callers, in the order
+of calls) until a token is available. The result (success, timeout or
+cancellation error) is passed to grant_handler, synchronously if the token is
+available immediately.
+*/
+class token_bucket : public interface_type
+{
+public:
+    virtual void acquire_token(
+        std::chrono::time_point<eclock> timeout_end, result_handler<void> &&grant_handler) = 0;
+};
+
+
+/*!
+Create token bucket implemented with GCRA (generic cell rate algorithm).
+
+One token is added to the bucket every token_interval (in event loop time), up
+to burst_size tokens, so short bursts of up to burst_size requests pass without
+any delay. All waiting calls are served from single timer.
+*/
+std::shared_ptr<token_bucket> make_token_bucket(
+    event_loop &evloop, std::chrono::nanoseconds token_interval, unsigned burst_size);
+
+}
+
+#endif /* NOSYNC__TOKEN_BUCKET_H */
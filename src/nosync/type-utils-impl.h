@@ -3,7 +3,10 @@
 #define NOSYNC__TYPE_UTILS_IMPL_H
 
 #include <climits>
+#include <functional>
 #include <limits>
+#include <type_traits>
+#include <utility>
 
 
 namespace nosync
@@ -25,6 +28,20 @@ constexpr std::enable_if_t<!std::is_void<T1>::value, std::size_t> get_sizeof_sum
     return sizeof(T1) + get_sizeof_sum<TT...>();
 }
 
+
+template<typename T>
+constexpr auto get_is_std_hashable_impl(int) noexcept -> decltype(std::hash<T>()(std::declval<const T &>()), bool())
+{
+    return true;
+}
+
+
+template<typename T>
+constexpr bool get_is_std_hashable_impl(...) noexcept
+{
+    return false;
+}
+
 }
 
 
@@ -53,6 +70,13 @@ constexpr std::size_t get_sizeof_sum() noexcept
 }
 
 
+template<typename T>
+constexpr bool get_is_std_hashable() noexcept
+{
+    return type_utils_impl::get_is_std_hashable_impl<T>(0);
+}
+
+
 template<typename T>
 T make_copy(const T &value)
 {
@@ -26,6 +26,12 @@ constexpr std::size_t sizeof_in_atoms = get_sizeof_in_atoms<Atom, T>();
 template<typename ...T>
 constexpr std::size_t sizeof_sum = get_sizeof_sum<T...>();
 
+template<typename T>
+constexpr bool get_is_std_hashable() noexcept;
+
+template<typename T>
+constexpr bool is_std_hashable = get_is_std_hashable<T>();
+
 template<typename T>
 T make_copy(const T &value);
 
@@ -0,0 +1,278 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <ctime>
+#include <linux/errqueue.h>
+#include <map>
+#include <netinet/in.h>
+#include <nosync/fd-bytes-writer.h>
+#include <nosync/fd-utils.h>
+#include <nosync/net-utils.h>
+#include <nosync/raw-error-result.h>
+#include <nosync/result-utils.h>
+#include <nosync/type-utils.h>
+#include <nosync/zerocopy-fd-bytes-writer.h>
+#include <sys/socket.h>
+#include <system_error>
+#include <utility>
+
+using std::array;
+using std::enable_shared_from_this;
+using std::errc;
+using std::experimental::string_view;
+using std::make_error_code;
+using std::make_shared;
+using std::map;
+using std::move;
+using std::shared_ptr;
+using std::size_t;
+using std::string;
+using std::uint32_t;
+using std::unique_ptr;
+
+
+namespace nosync
+{
+
+namespace
+{
+
+class zerocopy_completions_tracker : public enable_shared_from_this<zerocopy_completions_tracker>
+{
+public:
+    zerocopy_completions_tracker(fd_watching_event_loop &evloop, shared_fd &&fd);
+
+    void add_pending_send(shared_ptr<const string> data);
+
+private:
+    void handle_error_queue();
+    void release_completed_sends(uint32_t first_seq, uint32_t last_seq);
+    void update_error_watch();
+
+    fd_watching_event_loop &evloop;
+    shared_fd fd;
+    uint32_t next_send_seq;
+    map<uint32_t, shared_ptr<const string>> pending_sends;
+    unique_ptr<activity_handle> error_watch_handle;
+};
+
+
+class zerocopy_write_job : public enable_shared_from_this<zerocopy_write_job>
+{
+public:
+    static void start(
+        fd_watching_event_loop &evloop, shared_fd &&fd, shared_ptr<zerocopy_completions_tracker> tracker,
+        string &&data, result_handler<void> &&res_handler);
+
+    zerocopy_write_job(
+        shared_fd &&fd, shared_ptr<zerocopy_completions_tracker> &&tracker,
+        string &&data, result_handler<void> &&res_handler);
+
+private:
+    void handle_write_chunk();
+    result<size_t> send_some_bytes();
+
+    shared_fd fd;
+    shared_ptr<zerocopy_completions_tracker> tracker;
+    shared_ptr<const string> data;
+    size_t data_offset;
+    result_handler<void> res_handler;
+    unique_ptr<activity_handle> write_watch_handle;
+};
+
+
+class zerocopy_fd_bytes_writer : public bytes_writer
+{
+public:
+    zerocopy_fd_bytes_writer(fd_watching_event_loop &evloop, shared_fd &&fd, size_t zerocopy_min_size);
+
+    void write_bytes(string &&data, result_handler<void> &&res_handler) override;
+
+private:
+    fd_watching_event_loop &evloop;
+    shared_fd fd;
+    size_t zerocopy_min_size;
+    shared_ptr<bytes_writer> copying_writer;
+    shared_ptr<zerocopy_completions_tracker> completions_tracker;
+};
+
+
+zerocopy_completions_tracker::zerocopy_completions_tracker(fd_watching_event_loop &evloop, shared_fd &&fd)
+    : evloop(evloop), fd(move(fd)), next_send_seq(0U), pending_sends(), error_watch_handle()
+{
+}
+
+
+void zerocopy_completions_tracker::add_pending_send(shared_ptr<const string> data)
+{
+    pending_sends.emplace(next_send_seq, move(data));
+    ++next_send_seq;
+
+    handle_error_queue();
+}
+
+
+void zerocopy_completions_tracker::handle_error_queue()
+{
+    bool any_message_received = false;
+    for (;;) {
+        array<char, CMSG_SPACE(sizeof(::sock_extended_err))> control_buf;
+        ::msghdr msg = {};
+        msg.msg_control = control_buf.data();
+        msg.msg_controllen = control_buf.size();
+
+        ssize_t recvmsg_res;
+        do {
+            recvmsg_res = ::recvmsg(*fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT);
+        } while (recvmsg_res == -1 && errno == EINTR);
+        if (recvmsg_res < 0) {
+            break;
+        }
+
+        any_message_received = true;
+
+        for (auto cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            const bool is_ip_error =
+                (cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR)
+                || (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR);
+            if (!is_ip_error) {
+                continue;
+            }
+
+            const auto *sock_err = reinterpret_cast<const ::sock_extended_err *>(CMSG_DATA(cmsg));
+            if (sock_err->ee_errno == 0 && sock_err->ee_origin == SO_EE_ORIGIN_ZEROCOPY) {
+                release_completed_sends(sock_err->ee_info, sock_err->ee_data);
+            }
+        }
+    }
+
+    if (!any_message_received && error_watch_handle && error_watch_handle->is_enabled()) {
+        // error condition not caused by the error queue (e.g. pending socket
+        // error) is cleared, so that the error watch is not woken up in a loop
+        get_socket_int_option(*fd, SOL_SOCKET, SO_ERROR);
+    }
+
+    update_error_watch();
+}
+
+
+void zerocopy_completions_tracker::update_error_watch()
+{
+    const bool is_watch_enabled = error_watch_handle && error_watch_handle->is_enabled();
+    if (pending_sends.empty() && is_watch_enabled) {
+        error_watch_handle->disable();
+    } else if (!pending_sends.empty() && !is_watch_enabled) {
+        error_watch_handle = evloop.add_watch(
+            *fd, fd_watch_mode::error,
+            [tracker = shared_from_this()]() {
+                tracker->handle_error_queue();
+            });
+    }
+}
+
+
+void zerocopy_completions_tracker::release_completed_sends(uint32_t first_seq, uint32_t last_seq)
+{
+    for (auto seq = first_seq;; ++seq) {
+        pending_sends.erase(seq);
+        if (seq == last_seq) {
+            break;
+        }
+    }
+}
+
+
+void zerocopy_write_job::start(
+    fd_watching_event_loop &evloop, shared_fd &&fd, shared_ptr<zerocopy_completions_tracker> tracker,
+    string &&data, result_handler<void> &&res_handler)
+{
+    auto fd_num = *fd;
+    auto job = make_shared<zerocopy_write_job>(move(fd), move(tracker), move(data), move(res_handler));
+    job->write_watch_handle = evloop.add_watch(
+        fd_num, fd_watch_mode::output,
+        [job]() {
+            job->handle_write_chunk();
+        });
+}
+
+
+zerocopy_write_job::zerocopy_write_job(
+    shared_fd &&fd, shared_ptr<zerocopy_completions_tracker> &&tracker,
+    string &&data, result_handler<void> &&res_handler)
+    : fd(move(fd)), tracker(move(tracker)), data(make_shared<const string>(move(data))), data_offset(0U),
+    res_handler(move(res_handler))
+{
+}
+
+
+void zerocopy_write_job::handle_write_chunk()
+{
+    auto send_result = send_some_bytes();
+    if (send_result.is_ok()) {
+        data_offset += send_result.get_value();
+        if (data_offset >= data->size()) {
+            if (write_watch_handle->is_enabled()) {
+                write_watch_handle->disable();
+            }
+            res_handler(make_ok_result());
+        }
+    } else if (send_result.get_error() != make_error_code(errc::resource_unavailable_try_again)) {
+        if (write_watch_handle->is_enabled()) {
+            write_watch_handle->disable();
+        }
+        res_handler(raw_error_result(send_result));
+    }
+}
+
+
+result<size_t> zerocopy_write_job::send_some_bytes()
+{
+    const auto remaining_data = string_view(*data).substr(data_offset);
+
+    ssize_t send_res;
+    do {
+        send_res = ::send(
+            *fd, remaining_data.data(), remaining_data.size(), MSG_ZEROCOPY | MSG_DONTWAIT | MSG_NOSIGNAL);
+    } while (send_res == -1 && errno == EINTR);
+
+    if (send_res >= 0) {
+        tracker->add_pending_send(data);
+        return make_ok_result(static_cast<size_t>(send_res));
+    } else if (errno == ENOBUFS) {
+        return write_some_bytes_to_fd(*fd, remaining_data);
+    }
+
+    return make_raw_error_result_from_errno();
+}
+
+
+zerocopy_fd_bytes_writer::zerocopy_fd_bytes_writer(fd_watching_event_loop &evloop, shared_fd &&fd, size_t zerocopy_min_size)
+    : evloop(evloop), fd(move(fd)), zerocopy_min_size(zerocopy_min_size),
+    copying_writer(make_fd_bytes_writer(evloop, make_copy(this->fd))), completions_tracker()
+{
+    if (set_socket_int_option(*this->fd, SOL_SOCKET, SO_ZEROCOPY, 1).is_ok()) {
+        completions_tracker = make_shared<zerocopy_completions_tracker>(evloop, make_copy(this->fd));
+    }
+}
+
+
+void zerocopy_fd_bytes_writer::write_bytes(string &&data, result_handler<void> &&res_handler)
+{
+    if (completions_tracker && data.size() >= zerocopy_min_size) {
+        zerocopy_write_job::start(evloop, make_copy(fd), completions_tracker, move(data), move(res_handler));
+    } else {
+        copying_writer->write_bytes(move(data), move(res_handler));
+    }
+}
+
+}
+
+
+shared_ptr<bytes_writer> make_zerocopy_fd_bytes_writer(
+    fd_watching_event_loop &evloop, shared_fd &&fd, size_t zerocopy_min_size)
+{
+    return make_shared<zerocopy_fd_bytes_writer>(evloop, move(fd), zerocopy_min_size);
+}
+
+}
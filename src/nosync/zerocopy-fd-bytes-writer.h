@@ -0,0 +1,38 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#ifndef NOSYNC__ZEROCOPY_FD_BYTES_WRITER_H
+#define NOSYNC__ZEROCOPY_FD_BYTES_WRITER_H
+
+#include <cstddef>
+#include <memory>
+#include <nosync/bytes-writer.h>
+#include <nosync/fd-watching-event-loop.h>
+#include <nosync/shared-fd.h>
+
+
+namespace nosync
+{
+
+/*!
+Create bytes_writer which sends large writes to socket with MSG_ZEROCOPY.
+
+Writes of at least zerocopy_min_size bytes are sent with MSG_ZEROCOPY flag
+(Linux 4.14+, TCP/UDP sockets), so that the kernel uses pages of the written
+string directly instead of copying them. The string is kept alive by the
+writer until the kernel reports (via socket error queue, watched with error
+mode fd watch while any send is pending) that it doesn't use it any more - also
+after the writer is destroyed.
+Smaller writes (for which page pinning costs more than copying, the sensible
+threshold is usually around 10 KiB) are done like in fd_bytes_writer, which is
+also used for all writes if zero-copy can't be enabled for the socket.
+
+Small and large writes are sent independently of each other, so data of
+concurrent writes can be interleaved. The caller must start next write only
+after the previous one completes (e.g. by wrapping the writer with
+make_sequential_chunks_writer()).
+*/
+std::shared_ptr<bytes_writer> make_zerocopy_fd_bytes_writer(
+    fd_watching_event_loop &evloop, shared_fd &&fd, std::size_t zerocopy_min_size);
+
+}
+
+#endif /* NOSYNC__ZEROCOPY_FD_BYTES_WRITER_H */
@@ -0,0 +1,158 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#include <chrono>
+#include <functional>
+#include <gtest/gtest.h>
+#include <memory>
+#include <nosync/adaptive-concurrency-limited-request-handler.h>
+#include <nosync/func-request-handler.h>
+#include <nosync/manual-event-loop.h>
+#include <nosync/result.h>
+#include <nosync/type-utils.h>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using namespace std::chrono_literals;
+using nosync::adaptive_concurrency_limit_config;
+using nosync::make_adaptive_concurrency_limited_request_handler;
+using nosync::make_copy;
+using nosync::make_func_request_handler;
+using nosync::make_ok_result;
+using nosync::make_unlimited_requests_queue_capacity;
+using nosync::manual_event_loop;
+using nosync::result;
+using nosync::result_handler;
+using std::invalid_argument;
+using std::move;
+using std::vector;
+
+
+TEST(NosyncAdaptiveConcurrencyLimitedRequestHandler, AdjustLimitToLatency)
+{
+    auto evloop = manual_event_loop::create();
+
+    vector<result_handler<int>> base_res_handlers;
+    auto limited_handler = make_adaptive_concurrency_limited_request_handler<int, int>(
+        *evloop, adaptive_concurrency_limit_config{2, 1, 4, 2.0, 0.5, 1000ns}, make_unlimited_requests_queue_capacity(),
+        make_func_request_handler<int, int>(
+            [&base_res_handlers](auto &&, auto, auto &&res_handler) {
+                base_res_handlers.push_back(move(res_handler));
+            }));
+
+    vector<result<int>> results;
+    auto result_pusher = [&results](auto res) {
+        results.push_back(move(res));
+    };
+
+    for (int i = 0; i < 6; ++i) {
+        limited_handler->handle_request(make_copy(i), 100ns, result_pusher);
+    }
+    ASSERT_EQ(base_res_handlers.size(), 2U);
+
+    evloop->process_time_passage(1ns);
+    base_res_handlers[0](make_ok_result(0));
+    base_res_handlers[1](make_ok_result(1));
+    ASSERT_EQ(base_res_handlers.size(), 4U);
+
+    evloop->process_time_passage(1ns);
+    base_res_handlers[2](make_ok_result(2));
+    ASSERT_EQ(base_res_handlers.size(), 6U);
+
+    evloop->process_time_passage(10ns);
+    base_res_handlers[3](make_ok_result(3));
+    base_res_handlers[4](make_ok_result(4));
+    base_res_handlers[5](make_ok_result(5));
+    ASSERT_EQ(results.size(), 6U);
+
+    for (int i = 0; i < 3; ++i) {
+        limited_handler->handle_request(make_copy(i), 100ns, result_pusher);
+    }
+    ASSERT_EQ(base_res_handlers.size(), 7U);
+}
+
+
+TEST(NosyncAdaptiveConcurrencyLimitedRequestHandler, IgnoreZeroLatency)
+{
+    auto evloop = manual_event_loop::create();
+
+    vector<result_handler<int>> base_res_handlers;
+    auto limited_handler = make_adaptive_concurrency_limited_request_handler<int, int>(
+        *evloop, adaptive_concurrency_limit_config{2, 1, 2, 2.0, 0.5, 1000ns}, make_unlimited_requests_queue_capacity(),
+        make_func_request_handler<int, int>(
+            [&base_res_handlers](auto &&, auto, auto &&res_handler) {
+                base_res_handlers.push_back(move(res_handler));
+            }));
+
+    vector<result<int>> results;
+    auto result_pusher = [&results](auto res) {
+        results.push_back(move(res));
+    };
+
+    limited_handler->handle_request(0, 100ns, result_pusher);
+    base_res_handlers[0](make_ok_result(0));
+
+    for (int i = 1; i <= 4; ++i) {
+        limited_handler->handle_request(make_copy(i), 100ns, result_pusher);
+    }
+    ASSERT_EQ(base_res_handlers.size(), 3U);
+
+    evloop->process_time_passage(2ns);
+    base_res_handlers[1](make_ok_result(1));
+    base_res_handlers[2](make_ok_result(2));
+    ASSERT_EQ(base_res_handlers.size(), 5U);
+    ASSERT_EQ(results.size(), 3U);
+}
+
+
+TEST(NosyncAdaptiveConcurrencyLimitedRequestHandler, DecayMinLatency)
+{
+    auto evloop = manual_event_loop::create();
+
+    vector<result_handler<int>> base_res_handlers;
+    auto limited_handler = make_adaptive_concurrency_limited_request_handler<int, int>(
+        *evloop, adaptive_concurrency_limit_config{2, 1, 2, 2.0, 0.5, 10ns}, make_unlimited_requests_queue_capacity(),
+        make_func_request_handler<int, int>(
+            [&base_res_handlers](auto &&, auto, auto &&res_handler) {
+                base_res_handlers.push_back(move(res_handler));
+            }));
+
+    auto ignore_result = [](auto) {
+    };
+
+    limited_handler->handle_request(0, 1000ns, ignore_result);
+    evloop->process_time_passage(1ns);
+    base_res_handlers.back()(make_ok_result(0));
+
+    evloop->process_time_passage(30ns);
+    limited_handler->handle_request(1, 1000ns, ignore_result);
+    evloop->process_time_passage(5ns);
+    base_res_handlers.back()(make_ok_result(1));
+
+    for (int i = 2; i <= 4; ++i) {
+        limited_handler->handle_request(make_copy(i), 1000ns, ignore_result);
+    }
+    ASSERT_EQ(base_res_handlers.size(), 4U);
+
+    evloop->process_time_passage(5ns);
+    base_res_handlers[2](make_ok_result(2));
+    ASSERT_EQ(base_res_handlers.size(), 5U);
+}
+
+
+TEST(NosyncAdaptiveConcurrencyLimitedRequestHandler, InvalidConfig)
+{
+    auto evloop = manual_event_loop::create();
+
+    auto make_limited_handler = [&evloop](const adaptive_concurrency_limit_config &limit_config) {
+        return make_adaptive_concurrency_limited_request_handler<int, int>(
+            *evloop, limit_config, make_unlimited_requests_queue_capacity(),
+            make_func_request_handler<int, int>(
+                [](auto &&, auto, auto &&) {
+                }));
+    };
+
+    ASSERT_THROW(make_limited_handler(adaptive_concurrency_limit_config{1, 0, 4, 2.0, 0.5, 1000ns}), invalid_argument);
+    ASSERT_THROW(make_limited_handler(adaptive_concurrency_limit_config{5, 1, 4, 2.0, 0.5, 1000ns}), invalid_argument);
+    ASSERT_THROW(make_limited_handler(adaptive_concurrency_limit_config{2, 1, 4, 2.0, 0.5, 0ns}), invalid_argument);
+    ASSERT_NO_THROW(make_limited_handler(adaptive_concurrency_limit_config{1, 1, 4, 2.0, 0.5, 1000ns}));
+}
@@ -0,0 +1,180 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#include <chrono>
+#include <functional>
+#include <gtest/gtest.h>
+#include <memory>
+#include <nosync/caching-request-handler.h>
+#include <nosync/func-request-handler.h>
+#include <nosync/manual-event-loop.h>
+#include <nosync/result.h>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace std::chrono_literals;
+using namespace std::string_literals;
+using nosync::caching_request_handler_config;
+using nosync::make_caching_request_handler;
+using nosync::make_error_result;
+using nosync::make_func_request_handler;
+using nosync::make_ok_result;
+using nosync::manual_event_loop;
+using nosync::result;
+using nosync::result_handler;
+using std::errc;
+using std::move;
+using std::string;
+using std::tuple;
+using std::vector;
+
+
+namespace
+{
+
+constexpr auto test_req_timeout = 10ns;
+
+}
+
+
+TEST(NosyncCachingRequestHandler, CacheResults)
+{
+    auto evloop = manual_event_loop::create();
+
+    vector<tuple<string, result_handler<string>>> base_requests;
+    auto caching_handler = make_caching_request_handler<string, string, string>(
+        *evloop, caching_request_handler_config{2, 10ns, 5ns, 0ns},
+        make_func_request_handler<string, string>(
+            [&base_requests](auto &&req, auto, auto &&res_handler) {
+                base_requests.emplace_back(move(req), move(res_handler));
+            }),
+        [](const string &req) {
+            return req;
+        });
+
+    vector<result<string>> results;
+    auto result_pusher = [&results](auto res) {
+        results.push_back(move(res));
+    };
+
+    caching_handler->handle_request("a"s, test_req_timeout, result_pusher);
+    caching_handler->handle_request("b"s, test_req_timeout, result_pusher);
+    ASSERT_EQ(base_requests.size(), 2U);
+    std::get<result_handler<string>>(base_requests[0])(make_ok_result("A"s));
+    std::get<result_handler<string>>(base_requests[1])(make_error_result<string>(errc::io_error));
+    ASSERT_EQ(results.size(), 2U);
+
+    caching_handler->handle_request("a"s, test_req_timeout, result_pusher);
+    caching_handler->handle_request("b"s, test_req_timeout, result_pusher);
+    ASSERT_EQ(base_requests.size(), 2U);
+    evloop->process_time_passage(0ns);
+    ASSERT_EQ(results.size(), 4U);
+    ASSERT_EQ(results[2], make_ok_result("A"s));
+    ASSERT_EQ(results[3], make_error_result<string>(errc::io_error));
+
+    evloop->process_time_passage(5ns);
+    caching_handler->handle_request("b"s, test_req_timeout, result_pusher);
+    ASSERT_EQ(base_requests.size(), 3U);
+    std::get<result_handler<string>>(base_requests[2])(make_ok_result("B"s));
+
+    caching_handler->handle_request("c"s, test_req_timeout, result_pusher);
+    ASSERT_EQ(base_requests.size(), 4U);
+    std::get<result_handler<string>>(base_requests[3])(make_ok_result("C"s));
+
+    caching_handler->handle_request("a"s, test_req_timeout, result_pusher);
+    ASSERT_EQ(base_requests.size(), 5U);
+
+    const auto stats = caching_handler->get_stats();
+    ASSERT_EQ(stats.hits, 2U);
+    ASSERT_EQ(stats.stale_hits, 0U);
+    ASSERT_EQ(stats.misses, 5U);
+}
+
+
+TEST(NosyncCachingRequestHandler, StaleWhileRevalidate)
+{
+    auto evloop = manual_event_loop::create();
+
+    vector<tuple<string, result_handler<string>>> base_requests;
+    auto caching_handler = make_caching_request_handler<string, string, string>(
+        *evloop, caching_request_handler_config{10, 10ns, 0ns, 10ns},
+        make_func_request_handler<string, string>(
+            [&base_requests](auto &&req, auto, auto &&res_handler) {
+                base_requests.emplace_back(move(req), move(res_handler));
+            }),
+        [](const string &req) {
+            return req;
+        });
+
+    vector<result<string>> results;
+    auto result_pusher = [&results](auto res) {
+        results.push_back(move(res));
+    };
+
+    caching_handler->handle_request("a"s, test_req_timeout, result_pusher);
+    std::get<result_handler<string>>(base_requests[0])(make_ok_result("A1"s));
+
+    evloop->process_time_passage(15ns);
+    caching_handler->handle_request("a"s, test_req_timeout, result_pusher);
+    caching_handler->handle_request("a"s, test_req_timeout, result_pusher);
+    ASSERT_EQ(base_requests.size(), 2U);
+    evloop->process_time_passage(0ns);
+    ASSERT_EQ(results, vector<result<string>>(3, make_ok_result("A1"s)));
+
+    std::get<result_handler<string>>(base_requests[1])(make_ok_result("A2"s));
+    caching_handler->handle_request("a"s, test_req_timeout, result_pusher);
+    evloop->process_time_passage(0ns);
+    ASSERT_EQ(results.back(), make_ok_result("A2"s));
+    ASSERT_EQ(base_requests.size(), 2U);
+
+    const auto stats = caching_handler->get_stats();
+    ASSERT_EQ(stats.hits, 1U);
+    ASSERT_EQ(stats.stale_hits, 2U);
+    ASSERT_EQ(stats.misses, 1U);
+}
+
+
+TEST(NosyncCachingRequestHandler, NoDuplicateRefreshAfterMiss)
+{
+    auto evloop = manual_event_loop::create();
+
+    vector<tuple<string, result_handler<string>>> base_requests;
+    auto caching_handler = make_caching_request_handler<string, string, string>(
+        *evloop, caching_request_handler_config{10, 10ns, 0ns, 10ns},
+        make_func_request_handler<string, string>(
+            [&base_requests](auto &&req, auto, auto &&res_handler) {
+                base_requests.emplace_back(move(req), move(res_handler));
+            }),
+        [](const string &req) {
+            return req;
+        });
+
+    vector<result<string>> results;
+    auto result_pusher = [&results](auto res) {
+        results.push_back(move(res));
+    };
+
+    caching_handler->handle_request("a"s, test_req_timeout, result_pusher);
+    std::get<result_handler<string>>(base_requests[0])(make_ok_result("A1"s));
+
+    evloop->process_time_passage(15ns);
+    caching_handler->handle_request("a"s, test_req_timeout, result_pusher);
+    ASSERT_EQ(base_requests.size(), 2U);
+
+    evloop->process_time_passage(10ns);
+    caching_handler->handle_request("a"s, test_req_timeout, result_pusher);
+    ASSERT_EQ(base_requests.size(), 3U);
+    std::get<result_handler<string>>(base_requests[2])(make_ok_result("A3"s));
+
+    evloop->process_time_passage(15ns);
+    caching_handler->handle_request("a"s, test_req_timeout, result_pusher);
+    ASSERT_EQ(base_requests.size(), 3U);
+
+    std::get<result_handler<string>>(base_requests[1])(make_ok_result("A2"s));
+    evloop->process_time_passage(0ns);
+    ASSERT_EQ(
+        results,
+        vector<result<string>>({
+            make_ok_result("A1"s), make_ok_result("A1"s), make_ok_result("A3"s), make_ok_result("A3"s)}));
+}
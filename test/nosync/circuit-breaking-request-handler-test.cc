@@ -0,0 +1,132 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <nosync/circuit-breaking-request-handler.h>
+#include <nosync/func-request-handler.h>
+#include <nosync/manual-event-loop.h>
+#include <nosync/result.h>
+#include <stdexcept>
+#include <nosync/type-utils.h>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+using namespace std::chrono_literals;
+using nosync::circuit_breaker_config;
+using nosync::make_circuit_breaking_request_handler;
+using nosync::make_error_result;
+using nosync::make_copy;
+using nosync::make_func_request_handler;
+using nosync::make_ok_result;
+using nosync::manual_event_loop;
+using nosync::result;
+using nosync::result_handler;
+using std::errc;
+using std::move;
+using std::vector;
+
+
+TEST(NosyncCircuitBreakingRequestHandler, OpenAndProbe)
+{
+    auto evloop = manual_event_loop::create();
+
+    vector<result_handler<int>> base_requests;
+    auto breaking_handler = make_circuit_breaking_request_handler<int, int>(
+        *evloop, circuit_breaker_config{10ns, 3, 0.5, 20ns},
+        make_func_request_handler<int, int>(
+            [&base_requests](auto &&, auto, auto &&res_handler) {
+                base_requests.push_back(move(res_handler));
+            }));
+
+    vector<result<int>> results;
+    auto result_pusher = [&results](auto res) {
+        results.push_back(move(res));
+    };
+
+    for (int i = 0; i < 4; ++i) {
+        breaking_handler->handle_request(make_copy(i), 100ns, result_pusher);
+    }
+    ASSERT_EQ(base_requests.size(), 4U);
+
+    base_requests[0](make_ok_result(0));
+    base_requests[1](make_error_result<int>(errc::io_error));
+    base_requests[2](make_error_result<int>(errc::io_error));
+
+    breaking_handler->handle_request(4, 100ns, result_pusher);
+    evloop->process_time_passage(0ns);
+    ASSERT_EQ(base_requests.size(), 4U);
+    ASSERT_EQ(results.size(), 4U);
+    ASSERT_EQ(results[3], make_error_result<int>(errc::device_or_resource_busy));
+
+    base_requests[3](make_ok_result(3));
+    evloop->process_time_passage(20ns);
+    breaking_handler->handle_request(5, 100ns, result_pusher);
+    breaking_handler->handle_request(6, 100ns, result_pusher);
+    evloop->process_time_passage(0ns);
+    ASSERT_EQ(base_requests.size(), 5U);
+    ASSERT_EQ(results.size(), 6U);
+    ASSERT_EQ(results[5], make_error_result<int>(errc::device_or_resource_busy));
+
+    base_requests[4](make_error_result<int>(errc::io_error));
+    evloop->process_time_passage(19ns);
+    breaking_handler->handle_request(7, 100ns, result_pusher);
+    evloop->process_time_passage(1ns);
+    ASSERT_EQ(base_requests.size(), 5U);
+
+    breaking_handler->handle_request(8, 100ns, result_pusher);
+    base_requests[5](make_ok_result(8));
+    breaking_handler->handle_request(9, 100ns, result_pusher);
+    ASSERT_EQ(base_requests.size(), 7U);
+}
+
+
+TEST(NosyncCircuitBreakingRequestHandler, SlidingWindow)
+{
+    auto evloop = manual_event_loop::create();
+
+    vector<result_handler<int>> base_requests;
+    auto breaking_handler = make_circuit_breaking_request_handler<int, int>(
+        *evloop, circuit_breaker_config{10ns, 3, 0.5, 20ns},
+        make_func_request_handler<int, int>(
+            [&base_requests](auto &&, auto, auto &&res_handler) {
+                base_requests.push_back(move(res_handler));
+            }));
+
+    auto result_ignorer = [](auto) {};
+
+    for (int i = 0; i < 5; ++i) {
+        breaking_handler->handle_request(make_copy(i), 100ns, result_ignorer);
+    }
+
+    base_requests[0](make_error_result<int>(errc::io_error));
+    base_requests[1](make_error_result<int>(errc::io_error));
+    evloop->process_time_passage(10ns);
+    base_requests[2](make_ok_result(2));
+    base_requests[3](make_ok_result(3));
+    base_requests[4](make_error_result<int>(errc::io_error));
+
+    breaking_handler->handle_request(5, 100ns, result_ignorer);
+    ASSERT_EQ(base_requests.size(), 6U);
+}
+
+
+TEST(NosyncCircuitBreakingRequestHandler, InvalidConfig)
+{
+    auto evloop = manual_event_loop::create();
+
+    auto make_handler = [&evloop](const circuit_breaker_config &config) {
+        return make_circuit_breaking_request_handler<int, int>(
+            *evloop, config,
+            make_func_request_handler<int, int>(
+                [](auto &&, auto, auto &&) {
+                }));
+    };
+
+    ASSERT_THROW(make_handler(circuit_breaker_config{10ns, 3, 0.0, 20ns}), std::invalid_argument);
+    ASSERT_THROW(make_handler(circuit_breaker_config{10ns, 3, 1.5, 20ns}), std::invalid_argument);
+    ASSERT_THROW(make_handler(circuit_breaker_config{10ns, 0, 0.5, 20ns}), std::invalid_argument);
+    ASSERT_THROW(make_handler(circuit_breaker_config{0ns, 3, 0.5, 20ns}), std::invalid_argument);
+    ASSERT_THROW(make_handler(circuit_breaker_config{10ns, 3, 0.5, 0ns}), std::invalid_argument);
+    ASSERT_TRUE(make_handler(circuit_breaker_config{10ns, 1, 1.0, 20ns}));
+}
@@ -0,0 +1,72 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#include <chrono>
+#include <functional>
+#include <gtest/gtest.h>
+#include <memory>
+#include <nosync/coalescing-chunks-writer.h>
+#include <nosync/func-bytes-writer.h>
+#include <nosync/manual-event-loop.h>
+#include <nosync/result.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std::chrono_literals;
+using namespace std::string_literals;
+using nosync::make_coalescing_chunks_writer;
+using nosync::make_func_bytes_writer;
+using nosync::make_ok_result;
+using nosync::make_timeout_error_result;
+using nosync::manual_event_loop;
+using nosync::result;
+using nosync::result_handler;
+using std::move;
+using std::string;
+using std::vector;
+
+
+TEST(NosyncCoalescingChunksWriter, CoalesceChunks)
+{
+    auto evloop = manual_event_loop::create();
+
+    vector<string> written_data;
+    vector<result_handler<void>> write_res_handlers;
+    auto chunks_writer = make_coalescing_chunks_writer(
+        *evloop,
+        make_func_bytes_writer(
+            [&](auto &&data, auto &&res_handler) {
+                written_data.push_back(move(data));
+                write_res_handlers.push_back(move(res_handler));
+            }));
+
+    vector<result<void>> results;
+    auto result_pusher = [&results](auto res) {
+        results.push_back(move(res));
+    };
+
+    chunks_writer->handle_request("ab"s, 10ns, result_pusher);
+    chunks_writer->handle_request("cd"s, 10ns, result_pusher);
+    ASSERT_TRUE(written_data.empty());
+
+    evloop->process_time_passage(0ns);
+    ASSERT_EQ(written_data, vector<string>({"abcd"s}));
+
+    chunks_writer->handle_request("ef"s, 10ns, result_pusher);
+    chunks_writer->handle_request("gh"s, 1ns, result_pusher);
+    chunks_writer->handle_request("ij"s, 10ns, result_pusher);
+    evloop->process_time_passage(1ns);
+
+    ASSERT_EQ(results, vector<result<void>>({make_timeout_error_result<void>()}));
+    ASSERT_EQ(written_data.size(), 1U);
+
+    write_res_handlers.back()(make_ok_result());
+    ASSERT_EQ(results, vector<result<void>>({make_timeout_error_result<void>(), make_ok_result(), make_ok_result()}));
+    ASSERT_EQ(written_data, vector<string>({"abcd"s, "efij"s}));
+
+    write_res_handlers.back()(make_ok_result());
+    ASSERT_EQ(results.size(), 5U);
+    ASSERT_EQ(results.back(), make_ok_result());
+
+    evloop->process_time_passage(0ns);
+    ASSERT_EQ(written_data.size(), 2U);
+}
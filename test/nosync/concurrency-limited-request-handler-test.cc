@@ -0,0 +1,78 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#include <chrono>
+#include <functional>
+#include <gtest/gtest.h>
+#include <memory>
+#include <nosync/concurrency-limited-request-handler.h>
+#include <nosync/func-request-handler.h>
+#include <nosync/manual-event-loop.h>
+#include <nosync/result.h>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace std::chrono_literals;
+using nosync::make_concurrency_limited_request_handler;
+using nosync::make_func_request_handler;
+using nosync::make_ok_result;
+using nosync::make_timeout_error_result;
+using nosync::manual_event_loop;
+using nosync::result;
+using nosync::result_handler;
+using std::move;
+using std::tuple;
+using std::vector;
+
+
+TEST(NosyncConcurrencyLimitedRequestHandler, LimitInFlightRequests)
+{
+    auto evloop = manual_event_loop::create();
+
+    vector<tuple<int, result_handler<int>>> base_requests;
+    auto limited_handler = make_concurrency_limited_request_handler<int, int>(
+        *evloop, 2,
+        make_func_request_handler<int, int>(
+            [&base_requests](auto &&req, auto, auto &&res_handler) {
+                base_requests.emplace_back(req, move(res_handler));
+            }));
+
+    vector<result<int>> results;
+    auto result_pusher = [&results](auto res) {
+        results.push_back(move(res));
+    };
+
+    limited_handler->handle_request(1, 10ns, result_pusher);
+    limited_handler->handle_request(2, 10ns, result_pusher);
+    limited_handler->handle_request(3, 1ns, result_pusher);
+    limited_handler->handle_request(4, 10ns, result_pusher);
+    limited_handler->handle_request(5, 10ns, result_pusher);
+    ASSERT_EQ(base_requests.size(), 2U);
+
+    evloop->process_time_passage(1ns);
+    ASSERT_EQ(results, vector<result<int>>({make_timeout_error_result<int>()}));
+
+    std::get<result_handler<int>>(base_requests[1])(make_ok_result(20));
+    ASSERT_EQ(base_requests.size(), 3U);
+    ASSERT_EQ(std::get<int>(base_requests[2]), 4);
+
+    std::get<result_handler<int>>(base_requests[0])(make_ok_result(10));
+    ASSERT_EQ(base_requests.size(), 4U);
+    ASSERT_EQ(std::get<int>(base_requests[3]), 5);
+
+    ASSERT_EQ(results, vector<result<int>>({make_timeout_error_result<int>(), make_ok_result(20), make_ok_result(10)}));
+}
+
+
+TEST(NosyncConcurrencyLimitedRequestHandler, ZeroMaxInFlight)
+{
+    auto evloop = manual_event_loop::create();
+
+    ASSERT_THROW(
+        (make_concurrency_limited_request_handler<int, int>(
+            *evloop, 0,
+            make_func_request_handler<int, int>(
+                [](auto &&, auto, auto &&) {
+                }))),
+        std::invalid_argument);
+}
@@ -0,0 +1,162 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <nosync/event-loop-utils.h>
+#include <nosync/fd-transfer-job.h>
+#include <nosync/ppoll-based-event-loop.h>
+#include <nosync/shared-fd.h>
+#include <nosync/test/io-utils.h>
+#include <string>
+#include <sys/socket.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+using namespace std::chrono_literals;
+using namespace std::string_literals;
+using nosync::invoke_with_etime_delay;
+using nosync::make_ppoll_based_event_loop;
+using nosync::make_timeout_error_result;
+using nosync::result;
+using nosync::shared_fd;
+using nosync::start_fd_transfer_job;
+using nosync::test::read_nointr;
+using nosync::test::write_nointr;
+using std::array;
+using std::errc;
+using std::make_error_code;
+using std::move;
+using std::size_t;
+using std::string;
+using std::vector;
+
+
+namespace
+{
+
+const auto test_bytes = "0123456789"s;
+
+
+array<shared_fd, 2> make_test_socket_pair()
+{
+    array<int, 2> sock_fds;
+    EXPECT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, sock_fds.data()), 0);
+    return {shared_fd(sock_fds[0]), shared_fd(sock_fds[1])};
+}
+
+
+array<shared_fd, 2> make_test_pipe()
+{
+    array<int, 2> pipe_fds;
+    EXPECT_EQ(::pipe2(pipe_fds.data(), O_NONBLOCK | O_CLOEXEC), 0);
+    return {shared_fd(pipe_fds[0]), shared_fd(pipe_fds[1])};
+}
+
+
+string read_available_bytes(int fd)
+{
+    string read_buf(test_bytes.size() * 2, '\xFF');
+    auto read_size = read_nointr(fd, &read_buf[0], read_buf.size());
+    read_buf.resize(read_size >= 0 ? static_cast<size_t>(read_size) : 0U);
+    return read_buf;
+}
+
+}
+
+
+TEST(NosyncFdTransferJob, TransferFileToSocket)
+{
+    auto test_evloop = make_ppoll_based_event_loop();
+
+    char file_path[] = "/tmp/nosync-fd-transfer-test-XXXXXX";
+    shared_fd file_fd(::mkstemp(file_path));
+    ASSERT_GE(*file_fd, 0);
+    ::unlink(file_path);
+    ASSERT_EQ(write_nointr(*file_fd, test_bytes.data(), test_bytes.size()), static_cast<int>(test_bytes.size()));
+
+    auto socks = make_test_socket_pair();
+
+    vector<result<size_t>> saved_results;
+    auto res_saver = [&saved_results](auto transfer_res) {
+        saved_results.push_back(move(transfer_res));
+    };
+
+    start_fd_transfer_job(*test_evloop, shared_fd(file_fd), shared_fd(socks[0]), 2, 5, 1s, res_saver);
+    test_evloop->run_iterations();
+
+    ASSERT_EQ(saved_results.size(), 1U);
+    ASSERT_TRUE(saved_results[0].is_ok());
+    ASSERT_EQ(saved_results[0].get_value(), 5U);
+    ASSERT_EQ(read_available_bytes(*socks[1]), test_bytes.substr(2, 5));
+
+    start_fd_transfer_job(*test_evloop, shared_fd(file_fd), shared_fd(socks[0]), 4, 100, 1s, res_saver);
+    test_evloop->run_iterations();
+
+    ASSERT_EQ(saved_results.size(), 2U);
+    ASSERT_TRUE(saved_results[1].is_ok());
+    ASSERT_EQ(saved_results[1].get_value(), test_bytes.size() - 4);
+    ASSERT_EQ(read_available_bytes(*socks[1]), test_bytes.substr(4));
+}
+
+
+TEST(NosyncFdTransferJob, TransferPipeToSocket)
+{
+    auto test_evloop = make_ppoll_based_event_loop();
+
+    auto pipe_fds = make_test_pipe();
+    auto socks = make_test_socket_pair();
+
+    ASSERT_EQ(write_nointr(*pipe_fds[1], test_bytes.data(), 3), 3);
+
+    vector<result<size_t>> saved_results;
+    auto res_saver = [&saved_results](auto transfer_res) {
+        saved_results.push_back(move(transfer_res));
+    };
+
+    start_fd_transfer_job(*test_evloop, shared_fd(pipe_fds[0]), shared_fd(socks[0]), 0, 5, 1s, res_saver);
+    auto write_task_handle = invoke_with_etime_delay(
+        *test_evloop, 10ms,
+        [&pipe_fds]() {
+            ASSERT_EQ(write_nointr(*pipe_fds[1], test_bytes.data() + 3, 2), 2);
+        });
+    test_evloop->run_iterations();
+
+    ASSERT_EQ(saved_results.size(), 1U);
+    ASSERT_TRUE(saved_results[0].is_ok());
+    ASSERT_EQ(saved_results[0].get_value(), 5U);
+    ASSERT_EQ(read_available_bytes(*socks[1]), test_bytes.substr(0, 5));
+
+    start_fd_transfer_job(*test_evloop, shared_fd(pipe_fds[0]), shared_fd(socks[0]), 1, 5, 1s, res_saver);
+    test_evloop->run_iterations();
+
+    ASSERT_EQ(saved_results.size(), 2U);
+    ASSERT_FALSE(saved_results[1].is_ok());
+    ASSERT_EQ(saved_results[1].get_error(), make_error_code(errc::invalid_argument));
+}
+
+
+TEST(NosyncFdTransferJob, TransferTimeout)
+{
+    auto test_evloop = make_ppoll_based_event_loop();
+
+    auto pipe_fds = make_test_pipe();
+    auto socks = make_test_socket_pair();
+
+    ASSERT_EQ(write_nointr(*pipe_fds[1], test_bytes.data(), 3), 3);
+
+    vector<result<size_t>> saved_results;
+    start_fd_transfer_job(
+        *test_evloop, shared_fd(pipe_fds[0]), shared_fd(socks[0]), 0, 5, 10ms,
+        [&saved_results](auto transfer_res) {
+            saved_results.push_back(move(transfer_res));
+        });
+    test_evloop->run_iterations();
+
+    ASSERT_EQ(saved_results, vector<result<size_t>>({make_timeout_error_result<size_t>()}));
+    ASSERT_EQ(read_available_bytes(*socks[1]), test_bytes.substr(0, 3));
+}
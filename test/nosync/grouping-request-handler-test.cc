@@ -0,0 +1,74 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#include <chrono>
+#include <functional>
+#include <gtest/gtest.h>
+#include <memory>
+#include <nosync/func-request-handler.h>
+#include <nosync/grouping-request-handler.h>
+#include <nosync/manual-event-loop.h>
+#include <nosync/result.h>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace std::chrono_literals;
+using namespace std::string_literals;
+using nosync::make_func_request_handler;
+using nosync::make_grouping_request_handler;
+using nosync::make_ok_result;
+using nosync::make_timeout_error_result;
+using nosync::manual_event_loop;
+using nosync::result;
+using nosync::result_handler;
+using std::make_tuple;
+using std::move;
+using std::string;
+using std::tuple;
+using std::vector;
+
+
+TEST(NosyncGroupingRequestHandler, GroupRequestsWithEqualKeys)
+{
+    auto evloop = manual_event_loop::create();
+
+    vector<tuple<string, result_handler<string>>> base_requests;
+    auto grouping_handler = make_grouping_request_handler<string, string, char>(
+        *evloop,
+        make_func_request_handler<string, string>(
+            [&base_requests](auto &&req, auto, auto &&res_handler) {
+                base_requests.emplace_back(move(req), move(res_handler));
+            }),
+        [](const string &req) {
+            return req.front();
+        });
+
+    vector<tuple<unsigned, result<string>>> results;
+    auto make_result_pusher = [&results](unsigned req_no) {
+        return [&results, req_no](auto res) {
+            results.emplace_back(req_no, move(res));
+        };
+    };
+
+    grouping_handler->handle_request("a1"s, 10ns, make_result_pusher(1));
+    grouping_handler->handle_request("b1"s, 10ns, make_result_pusher(2));
+    grouping_handler->handle_request("a2"s, 2ns, make_result_pusher(3));
+    grouping_handler->handle_request("a3"s, 10ns, make_result_pusher(4));
+
+    ASSERT_EQ(base_requests.size(), 2U);
+    ASSERT_EQ(std::get<string>(base_requests[0]), "a1"s);
+    ASSERT_EQ(std::get<string>(base_requests[1]), "b1"s);
+
+    evloop->process_time_passage(2ns);
+    ASSERT_EQ(results.size(), 1U);
+    ASSERT_EQ(results[0], make_tuple(3U, make_timeout_error_result<string>()));
+
+    std::get<result_handler<string>>(base_requests[0])(make_ok_result("A"s));
+    ASSERT_EQ(results.size(), 3U);
+    ASSERT_EQ(results[1], make_tuple(1U, make_ok_result("A"s)));
+    ASSERT_EQ(results[2], make_tuple(4U, make_ok_result("A"s)));
+
+    grouping_handler->handle_request("a4"s, 10ns, make_result_pusher(5));
+    ASSERT_EQ(base_requests.size(), 3U);
+    ASSERT_EQ(std::get<string>(base_requests[2]), "a4"s);
+}
@@ -0,0 +1,174 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <nosync/func-request-handler.h>
+#include <nosync/hedging-request-handler.h>
+#include <nosync/manual-event-loop.h>
+#include <nosync/raw-error-result.h>
+#include <nosync/result.h>
+#include <nosync/type-utils.h>
+#include <stdexcept>
+#include <system_error>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace std::chrono_literals;
+using nosync::hedging_delay_config;
+using nosync::make_copy;
+using nosync::make_func_request_handler;
+using nosync::make_hedging_request_handler;
+using nosync::make_ok_result;
+using nosync::manual_event_loop;
+using nosync::raw_error_result;
+using nosync::request_handler;
+using nosync::result;
+using nosync::result_handler;
+using std::chrono::nanoseconds;
+using std::errc;
+using std::invalid_argument;
+using std::move;
+using std::shared_ptr;
+using std::tuple;
+using std::vector;
+
+
+namespace
+{
+
+shared_ptr<request_handler<int, int>> make_recording_request_handler(
+    vector<tuple<int, nanoseconds, result_handler<int>>> &requests)
+{
+    return make_func_request_handler<int, int>(
+        [&requests](auto &&req, auto timeout, auto &&res_handler) {
+            requests.emplace_back(req, timeout, move(res_handler));
+        });
+}
+
+}
+
+
+TEST(NosyncHedgingRequestHandler, StaticDelay)
+{
+    auto evloop = manual_event_loop::create();
+
+    vector<tuple<int, nanoseconds, result_handler<int>>> primary_requests;
+    vector<tuple<int, nanoseconds, result_handler<int>>> secondary_requests;
+    auto hedging_handler = make_hedging_request_handler<int, int>(
+        *evloop, hedging_delay_config{3ns, 0, 0},
+        make_recording_request_handler(primary_requests), make_recording_request_handler(secondary_requests));
+
+    vector<result<int>> results;
+    auto result_pusher = [&results](auto res) {
+        results.push_back(move(res));
+    };
+
+    hedging_handler->handle_request(1, 10ns, result_pusher);
+    hedging_handler->handle_request(2, 10ns, result_pusher);
+    hedging_handler->handle_request(3, 2ns, result_pusher);
+    ASSERT_EQ(primary_requests.size(), 3U);
+    ASSERT_EQ(std::get<int>(primary_requests[2]), 3);
+    ASSERT_EQ(std::get<nanoseconds>(primary_requests[2]), 2ns);
+
+    evloop->process_time_passage(1ns);
+    std::get<result_handler<int>>(primary_requests[0])(make_ok_result(10));
+    ASSERT_EQ(results, vector<result<int>>({make_ok_result(10)}));
+
+    evloop->process_time_passage(2ns);
+    ASSERT_EQ(secondary_requests.size(), 1U);
+    ASSERT_EQ(std::get<int>(secondary_requests[0]), 2);
+    ASSERT_EQ(std::get<nanoseconds>(secondary_requests[0]), 7ns);
+
+    std::get<result_handler<int>>(secondary_requests[0])(make_ok_result(21));
+    std::get<result_handler<int>>(primary_requests[1])(make_ok_result(20));
+    ASSERT_EQ(results, vector<result<int>>({make_ok_result(10), make_ok_result(21)}));
+
+    evloop->process_time_passage(10ns);
+    ASSERT_EQ(secondary_requests.size(), 1U);
+}
+
+
+TEST(NosyncHedgingRequestHandler, PercentileDelay)
+{
+    auto evloop = manual_event_loop::create();
+
+    vector<tuple<int, nanoseconds, result_handler<int>>> primary_requests;
+    vector<tuple<int, nanoseconds, result_handler<int>>> secondary_requests;
+    auto hedging_handler = make_hedging_request_handler<int, int>(
+        *evloop, hedging_delay_config{100ns, 0.5, 4},
+        make_recording_request_handler(primary_requests), make_recording_request_handler(secondary_requests));
+
+    vector<result<int>> results;
+    auto result_pusher = [&results](auto res) {
+        results.push_back(move(res));
+    };
+
+    for (int i = 1; i <= 4; ++i) {
+        hedging_handler->handle_request(make_copy(i), 1000ns, result_pusher);
+        evloop->process_time_passage(nanoseconds(i * 10));
+        std::get<result_handler<int>>(primary_requests.back())(make_ok_result(i));
+    }
+    ASSERT_EQ(results.size(), 4U);
+    ASSERT_TRUE(secondary_requests.empty());
+
+    hedging_handler->handle_request(5, 1000ns, result_pusher);
+    evloop->process_time_passage(19ns);
+    ASSERT_TRUE(secondary_requests.empty());
+    evloop->process_time_passage(1ns);
+    ASSERT_EQ(secondary_requests.size(), 1U);
+    ASSERT_EQ(std::get<int>(secondary_requests[0]), 5);
+    ASSERT_EQ(std::get<nanoseconds>(secondary_requests[0]), 980ns);
+}
+
+
+TEST(NosyncHedgingRequestHandler, PercentileDelayIgnoresErrors)
+{
+    auto evloop = manual_event_loop::create();
+
+    vector<tuple<int, nanoseconds, result_handler<int>>> primary_requests;
+    vector<tuple<int, nanoseconds, result_handler<int>>> secondary_requests;
+    auto hedging_handler = make_hedging_request_handler<int, int>(
+        *evloop, hedging_delay_config{100ns, 1, 1},
+        make_recording_request_handler(primary_requests), make_recording_request_handler(secondary_requests));
+
+    auto ignore_result = [](auto) {
+    };
+
+    hedging_handler->handle_request(1, 1000ns, ignore_result);
+    evloop->process_time_passage(10ns);
+    std::get<result_handler<int>>(primary_requests.back())(make_ok_result(1));
+
+    hedging_handler->handle_request(2, 1000ns, ignore_result);
+    evloop->process_time_passage(5ns);
+    std::get<result_handler<int>>(primary_requests.back())(raw_error_result(errc::connection_refused));
+    ASSERT_TRUE(secondary_requests.empty());
+
+    hedging_handler->handle_request(3, 1000ns, ignore_result);
+    evloop->process_time_passage(9ns);
+    ASSERT_TRUE(secondary_requests.empty());
+    evloop->process_time_passage(1ns);
+    ASSERT_EQ(secondary_requests.size(), 1U);
+}
+
+
+TEST(NosyncHedgingRequestHandler, InvalidPercentileConfig)
+{
+    auto evloop = manual_event_loop::create();
+
+    vector<tuple<int, nanoseconds, result_handler<int>>> requests;
+    ASSERT_THROW(
+        (make_hedging_request_handler<int, int>(
+            *evloop, hedging_delay_config{100ns, 0.5, 0},
+            make_recording_request_handler(requests), make_recording_request_handler(requests))),
+        invalid_argument);
+    ASSERT_THROW(
+        (make_hedging_request_handler<int, int>(
+            *evloop, hedging_delay_config{100ns, 1.5, 4},
+            make_recording_request_handler(requests), make_recording_request_handler(requests))),
+        invalid_argument);
+    ASSERT_NO_THROW(
+        (make_hedging_request_handler<int, int>(
+            *evloop, hedging_delay_config{100ns, 0, 0},
+            make_recording_request_handler(requests), make_recording_request_handler(requests))));
+}
@@ -7,6 +7,7 @@
 #include <nosync/input-messages-dispatch-handler.h>
 #include <nosync/manual-event-loop.h>
 #include <nosync/result.h>
+#include <nosync/type-utils.h>
 #include <string>
 #include <tuple>
 #include <utility>
@@ -16,6 +17,7 @@ using namespace std::chrono_literals;
 using namespace std::string_literals;
 using nosync::manual_event_loop;
 using nosync::make_func_request_handler;
+using nosync::make_copy;
 using nosync::make_input_messages_dispatch_handler;
 using nosync::make_ok_result;
 using nosync::make_timeout_error_result;
@@ -122,3 +124,99 @@ TEST(NosyncInputMessagesDispatchHandler, MultipleRequests)
     ASSERT_EQ(saved_results[2], make_tuple(4U, make_ok_result("4jklmn"s)));
     ASSERT_EQ(saved_results[3], make_tuple(5U, make_timeout_error_result<string>()));
 }
+
+
+TEST(NosyncInputMessagesDispatchHandler, DuplicateIdsAndTimeouts)
+{
+    auto evloop = manual_event_loop::create();
+
+    deque<string> input_msgs = {"1abc"s, "3de"s, "1fg"s};
+    auto msgs_reader = make_func_request_handler<nullptr_t, string>(
+        [&evloop, &input_msgs](auto, auto timeout, auto res_handler) {
+            if (!input_msgs.empty()) {
+                auto msg = input_msgs.front();
+                input_msgs.pop_front();
+                evloop->invoke_at(
+                    evloop->get_etime() + 2ns,
+                    [res_handler = move(res_handler), msg = move(msg)]() {
+                        res_handler(make_ok_result(msg));
+                    });
+            } else {
+                evloop->invoke_at(
+                    evloop->get_etime() + timeout,
+                    [res_handler = move(res_handler)]() {
+                        res_handler(make_timeout_error_result<string>());
+                    });
+            }
+        });
+
+    auto messages_dispatcher = make_input_messages_dispatch_handler(
+        *evloop, move(msgs_reader),
+        [](auto msg) {
+            return !msg.empty() ? std::experimental::make_optional(msg.substr(0, 1).to_string()) : nullopt;
+        });
+
+    vector<tuple<unsigned, result<string>>> saved_results;
+    for (auto req : {make_tuple(1U, 1U, 10ns), make_tuple(2U, 2U, 3ns), make_tuple(3U, 1U, 10ns), make_tuple(4U, 3U, 1ns)}) {
+        messages_dispatcher->handle_request(
+            to_string(std::get<1>(req)), std::get<2>(req),
+            [req_no = std::get<0>(req), &saved_results](auto res) {
+                saved_results.emplace_back(req_no, move(res));
+            });
+    }
+
+    evloop->process_time_passage(0ns);
+    for (unsigned i = 0; i < 20; ++i) {
+        evloop->process_time_passage(1ns);
+        while (evloop->get_earliest_task_time() == std::experimental::make_optional(evloop->get_etime())) {
+            evloop->process_time_passage(0ns);
+        }
+    }
+
+    ASSERT_EQ(saved_results.size(), 4U);
+    ASSERT_EQ(saved_results[0], make_tuple(4U, make_timeout_error_result<string>()));
+    ASSERT_EQ(saved_results[1], make_tuple(1U, make_ok_result("1abc"s)));
+    ASSERT_EQ(saved_results[2], make_tuple(2U, make_timeout_error_result<string>()));
+    ASSERT_EQ(saved_results[3], make_tuple(3U, make_ok_result("1fg"s)));
+}
+
+
+TEST(NosyncInputMessagesDispatchHandler, IntegerIds)
+{
+    auto evloop = manual_event_loop::create();
+
+    deque<string> input_msgs = {"2de"s, "1abc"s};
+    auto msgs_reader = make_func_request_handler<nullptr_t, string>(
+        [&evloop, &input_msgs](auto, auto, auto res_handler) {
+            auto msg = input_msgs.front();
+            input_msgs.pop_front();
+            evloop->invoke_at(
+                evloop->get_etime() + 1ns,
+                [res_handler = move(res_handler), msg = move(msg)]() {
+                    res_handler(make_ok_result(msg));
+                });
+        });
+
+    auto messages_dispatcher = make_input_messages_dispatch_handler<unsigned>(
+        *evloop, move(msgs_reader),
+        [](auto msg) {
+            return !msg.empty() ? std::experimental::make_optional<unsigned>(msg[0] - '0') : nullopt;
+        });
+
+    vector<tuple<unsigned, result<string>>> saved_results;
+    for (unsigned id : {1, 2}) {
+        messages_dispatcher->handle_request(
+            make_copy(id), test_req_timeout,
+            [id, &saved_results](auto res) {
+                saved_results.emplace_back(id, move(res));
+            });
+    }
+
+    for (unsigned i = 0; i < 3; ++i) {
+        evloop->process_time_passage(1ns);
+    }
+
+    ASSERT_EQ(saved_results.size(), 2U);
+    ASSERT_EQ(saved_results[0], make_tuple(2U, make_ok_result("2de"s)));
+    ASSERT_EQ(saved_results[1], make_tuple(1U, make_ok_result("1abc"s)));
+}
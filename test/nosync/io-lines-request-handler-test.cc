@@ -0,0 +1,124 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#include <chrono>
+#include <gtest/gtest.h>
+#include <nosync/func-bytes-reader.h>
+#include <nosync/func-bytes-writer.h>
+#include <nosync/io-lines-request-handler.h>
+#include <nosync/manual-event-loop.h>
+#include <nosync/reader-writer-bytes-io.h>
+#include <nosync/result-handler-utils.h>
+#include <nosync/result.h>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace std::chrono_literals;
+using namespace std::string_literals;
+using nosync::invoke_result_handler_later;
+using nosync::make_coalescing_io_lines_request_handler;
+using nosync::make_func_bytes_reader;
+using nosync::make_func_bytes_writer;
+using nosync::make_io_lines_request_handler;
+using nosync::make_ok_result;
+using nosync::make_reader_writer_bytes_io;
+using nosync::manual_event_loop;
+using nosync::result;
+using nosync::result_handler;
+using std::make_tuple;
+using std::move;
+using std::string;
+using std::tuple;
+using std::vector;
+
+
+TEST(NosyncIoLinesRequestHandler, CoalesceRequestLines)
+{
+    auto evloop = manual_event_loop::create();
+
+    vector<string> written_data;
+    result_handler<string> pending_read_res_handler;
+    auto handler = make_coalescing_io_lines_request_handler(
+        *evloop,
+        make_reader_writer_bytes_io(
+            make_func_bytes_reader(
+                [&](auto, auto, auto res_handler) {
+                    pending_read_res_handler = move(res_handler);
+                }),
+            make_func_bytes_writer(
+                [&](auto &&data, auto &&res_handler) {
+                    written_data.push_back(move(data));
+                    invoke_result_handler_later(*evloop, move(res_handler), make_ok_result());
+                })));
+
+    vector<tuple<string, result<string>>> results;
+    auto make_result_pusher = [&results](string req) {
+        return [&results, req](auto res) {
+            results.emplace_back(req, move(res));
+        };
+    };
+
+    handler->handle_request("a"s, 1s, make_result_pusher("a"));
+    handler->handle_request("b"s, 1s, make_result_pusher("b"));
+    handler->handle_request("c"s, 1s, make_result_pusher("c"));
+    ASSERT_TRUE(written_data.empty());
+
+    evloop->process_time_passage(0ns);
+    ASSERT_EQ(
+        written_data,
+        vector<string>({"0000000000000000:a\n0000000000000001:b\n0000000000000002:c\n"s}));
+    ASSERT_TRUE(results.empty());
+    ASSERT_TRUE(pending_read_res_handler);
+
+    auto read_res_handler = move(pending_read_res_handler);
+    pending_read_res_handler = nullptr;
+    read_res_handler(make_ok_result("0000000000000002:C\n0000000000000000:A\n0000000000000001:B\n"s));
+    evloop->process_time_passage(0ns);
+
+    ASSERT_EQ(
+        results,
+        (vector<tuple<string, result<string>>>({
+            make_tuple("c"s, make_ok_result("C"s)),
+            make_tuple("a"s, make_ok_result("A"s)),
+            make_tuple("b"s, make_ok_result("B"s)),
+        })));
+    ASSERT_EQ(written_data.size(), 1U);
+}
+
+
+TEST(NosyncIoLinesRequestHandler, IgnoreInexactResponseIds)
+{
+    auto evloop = manual_event_loop::create();
+
+    result_handler<string> pending_read_res_handler;
+    auto handler = make_io_lines_request_handler(
+        *evloop,
+        make_reader_writer_bytes_io(
+            make_func_bytes_reader(
+                [&](auto, auto, auto res_handler) {
+                    pending_read_res_handler = move(res_handler);
+                }),
+            make_func_bytes_writer(
+                [&](auto &&, auto &&res_handler) {
+                    invoke_result_handler_later(*evloop, move(res_handler), make_ok_result());
+                })));
+
+    vector<result<string>> results;
+    for (unsigned i = 0; i < 11; ++i) {
+        handler->handle_request(
+            "r"s, 1s,
+            [&results](auto res) {
+                results.push_back(move(res));
+            });
+    }
+
+    evloop->process_time_passage(0ns);
+    ASSERT_TRUE(pending_read_res_handler);
+
+    auto read_res_handler = move(pending_read_res_handler);
+    pending_read_res_handler = nullptr;
+    read_res_handler(make_ok_result("0:X\n00000000000000000:Y\n000000000000000a:Z\n000000000000000A:W\n"s));
+    evloop->process_time_passage(0ns);
+
+    ASSERT_EQ(results, vector<result<string>>({make_ok_result("W"s)}));
+}
@@ -0,0 +1,159 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <memory>
+#include <nosync/func-request-handler.h>
+#include <nosync/load-balancing-request-handler.h>
+#include <nosync/result.h>
+#include <nosync/type-utils.h>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using namespace std::chrono_literals;
+using nosync::load_balancing_policy;
+using nosync::make_copy;
+using nosync::make_func_request_handler;
+using nosync::make_load_balancing_request_handler;
+using nosync::make_ok_result;
+using nosync::request_handler;
+using nosync::result;
+using nosync::result_handler;
+using std::array;
+using std::move;
+using std::shared_ptr;
+using std::vector;
+
+
+namespace
+{
+
+template<std::size_t N>
+vector<shared_ptr<request_handler<int, int>>> make_recording_backends(
+    array<vector<result_handler<int>>, N> &backend_requests)
+{
+    vector<shared_ptr<request_handler<int, int>>> backends;
+    for (auto &requests : backend_requests) {
+        backends.push_back(
+            make_func_request_handler<int, int>(
+                [&requests](auto &&, auto, auto &&res_handler) {
+                    requests.push_back(move(res_handler));
+                }));
+    }
+
+    return backends;
+}
+
+}
+
+
+TEST(NosyncLoadBalancingRequestHandler, RoundRobin)
+{
+    array<vector<result_handler<int>>, 3> backend_requests;
+    auto lb_handler = make_load_balancing_request_handler<int, int>(
+        load_balancing_policy::round_robin, make_recording_backends(backend_requests));
+
+    vector<result<int>> results;
+    auto result_pusher = [&results](auto res) {
+        results.push_back(move(res));
+    };
+
+    for (int i = 0; i < 7; ++i) {
+        lb_handler->handle_request(make_copy(i), 1ns, result_pusher);
+    }
+    ASSERT_EQ(backend_requests[0].size(), 3U);
+    ASSERT_EQ(backend_requests[1].size(), 2U);
+    ASSERT_EQ(backend_requests[2].size(), 2U);
+
+    backend_requests[1][0](make_ok_result(1));
+    ASSERT_EQ(results, vector<result<int>>({make_ok_result(1)}));
+}
+
+
+TEST(NosyncLoadBalancingRequestHandler, LeastOutstanding)
+{
+    array<vector<result_handler<int>>, 3> backend_requests;
+    auto lb_handler = make_load_balancing_request_handler<int, int>(
+        load_balancing_policy::least_outstanding, make_recording_backends(backend_requests));
+
+    auto result_ignorer = [](auto) {};
+
+    for (int i = 0; i < 3; ++i) {
+        lb_handler->handle_request(make_copy(i), 1ns, result_ignorer);
+    }
+    ASSERT_EQ(backend_requests[0].size(), 1U);
+    ASSERT_EQ(backend_requests[1].size(), 1U);
+    ASSERT_EQ(backend_requests[2].size(), 1U);
+
+    backend_requests[1][0](make_ok_result(1));
+    lb_handler->handle_request(3, 1ns, result_ignorer);
+    lb_handler->handle_request(4, 1ns, result_ignorer);
+    ASSERT_EQ(backend_requests[0].size(), 1U);
+    ASSERT_EQ(backend_requests[1].size(), 2U);
+    ASSERT_EQ(backend_requests[2].size(), 2U);
+}
+
+
+TEST(NosyncLoadBalancingRequestHandler, PowerOfTwoChoices)
+{
+    array<vector<result_handler<int>>, 4> backend_requests;
+    auto lb_handler = make_load_balancing_request_handler<int, int>(
+        load_balancing_policy::power_of_two_choices, make_recording_backends(backend_requests), 1234U);
+
+    auto result_ignorer = [](auto) {};
+
+    for (int i = 0; i < 100; ++i) {
+        lb_handler->handle_request(make_copy(i), 1ns, result_ignorer);
+        for (std::size_t j = 1; j < backend_requests.size(); ++j) {
+            for (auto &res_handler : backend_requests[j]) {
+                if (res_handler) {
+                    res_handler(make_ok_result(i));
+                    res_handler = nullptr;
+                }
+            }
+        }
+    }
+
+    ASSERT_LE(backend_requests[0].size(), 1U);
+    for (std::size_t j = 1; j < backend_requests.size(); ++j) {
+        ASSERT_GT(backend_requests[j].size(), 0U);
+    }
+}
+
+
+TEST(NosyncLoadBalancingRequestHandler, PowerOfTwoChoicesSeed)
+{
+    auto record_choices = [](std::uint_fast32_t random_seed) {
+        array<vector<result_handler<int>>, 5> backend_requests;
+        auto lb_handler = make_load_balancing_request_handler<int, int>(
+            load_balancing_policy::power_of_two_choices, make_recording_backends(backend_requests), random_seed);
+
+        vector<std::size_t> choices;
+        for (int i = 0; i < 20; ++i) {
+            lb_handler->handle_request(make_copy(i), 1ns, [](auto) {});
+            for (std::size_t j = 0; j < backend_requests.size(); ++j) {
+                if (!backend_requests[j].empty()) {
+                    choices.push_back(j);
+                    backend_requests[j].back()(make_ok_result(i));
+                    backend_requests[j].clear();
+                }
+            }
+        }
+
+        return choices;
+    };
+
+    const auto choices = record_choices(42U);
+    ASSERT_EQ(choices.size(), 20U);
+    ASSERT_EQ(record_choices(42U), choices);
+}
+
+
+TEST(NosyncLoadBalancingRequestHandler, NoBackends)
+{
+    ASSERT_THROW(
+        (make_load_balancing_request_handler<int, int>(load_balancing_policy::round_robin, {})),
+        std::invalid_argument);
+}
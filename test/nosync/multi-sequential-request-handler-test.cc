@@ -0,0 +1,69 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#include <chrono>
+#include <functional>
+#include <gtest/gtest.h>
+#include <memory>
+#include <nosync/func-request-handler.h>
+#include <nosync/manual-event-loop.h>
+#include <nosync/multi-sequential-request-handler.h>
+#include <nosync/result.h>
+#include <nosync/type-utils.h>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace std::chrono_literals;
+using nosync::make_copy;
+using nosync::make_func_request_handler;
+using nosync::make_multi_sequential_request_handler;
+using nosync::make_ok_result;
+using nosync::manual_event_loop;
+using nosync::result;
+using nosync::result_handler;
+using std::move;
+using std::tuple;
+using std::vector;
+
+
+TEST(NosyncMultiSequentialRequestHandler, RemoveIdleSubHandlers)
+{
+    auto evloop = manual_event_loop::create();
+
+    vector<tuple<int, result_handler<int>>> base_requests;
+    auto base_handler = make_func_request_handler<int, int>(
+        [&base_requests](auto &&req, auto, auto &&res_handler) {
+            base_requests.emplace_back(req, move(res_handler));
+        });
+
+    auto multi_seq_handler = make_multi_sequential_request_handler<int, int, int>(
+        *evloop, make_copy(base_handler),
+        [](const int &req) {
+            return req / 10;
+        });
+    ASSERT_EQ(base_handler.use_count(), 2);
+
+    vector<result<int>> results;
+    auto result_pusher = [&results](auto res) {
+        results.push_back(move(res));
+    };
+
+    multi_seq_handler->handle_request(11, 10ns, result_pusher);
+    multi_seq_handler->handle_request(12, 10ns, result_pusher);
+    multi_seq_handler->handle_request(21, 10ns, result_pusher);
+    ASSERT_EQ(base_requests.size(), 2U);
+    ASSERT_EQ(std::get<int>(base_requests[0]), 11);
+    ASSERT_EQ(std::get<int>(base_requests[1]), 21);
+    ASSERT_EQ(base_handler.use_count(), 4);
+
+    std::get<result_handler<int>>(base_requests[1])(make_ok_result(21));
+    ASSERT_EQ(base_handler.use_count(), 3);
+
+    std::get<result_handler<int>>(base_requests[0])(make_ok_result(11));
+    ASSERT_EQ(base_requests.size(), 3U);
+    ASSERT_EQ(std::get<int>(base_requests[2]), 12);
+    ASSERT_EQ(base_handler.use_count(), 3);
+
+    std::get<result_handler<int>>(base_requests[2])(make_ok_result(12));
+    ASSERT_EQ(base_handler.use_count(), 2);
+    ASSERT_EQ(results.size(), 3U);
+}
@@ -0,0 +1,141 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <nosync/net-utils.h>
+#include <string>
+#include <sys/socket.h>
+
+using nosync::get_socket_int_option;
+using nosync::get_socket_local_address;
+using nosync::inline_socket_address;
+using nosync::make_ipv4_localhost_socket_address;
+using nosync::make_ipv6_localhost_socket_address;
+using nosync::make_numeric_ip_socket_address;
+using nosync::make_ok_result;
+using nosync::open_bound_datagram_socket;
+using nosync::open_connected_datagram_socket;
+using nosync::open_listening_stream_socket;
+using nosync::open_reuseport_listening_stream_sockets;
+using nosync::receive_datagram_via_socket;
+using nosync::socket_address;
+using nosync::socket_options;
+using std::get;
+using std::string;
+
+
+namespace
+{
+
+string get_socket_address_bytes(const socket_address &addr)
+{
+    const auto addr_view = addr.get_view();
+
+    return string(reinterpret_cast<const char *>(addr_view.addr), addr_view.addr_size);
+}
+
+
+string get_socket_local_address_bytes(int sock_fd)
+{
+    auto addr_res = get_socket_local_address(sock_fd);
+    if (!addr_res.is_ok()) {
+        return {};
+    }
+
+    return get_socket_address_bytes(*addr_res.get_value());
+}
+
+}
+
+
+TEST(NosyncNetUtils, OpenReuseportListeningSockets)
+{
+    auto sock_fds_res = open_reuseport_listening_stream_sockets(
+        make_ipv4_localhost_socket_address(0)->get_view(), 4, 3);
+    ASSERT_TRUE(sock_fds_res.is_ok());
+
+    const auto &sock_fds = sock_fds_res.get_value();
+    ASSERT_EQ(sock_fds.size(), 3U);
+
+    const auto first_addr_bytes = get_socket_local_address_bytes(*sock_fds[0]);
+    ASSERT_FALSE(first_addr_bytes.empty());
+
+    for (const auto &sock_fd : sock_fds) {
+        ASSERT_EQ(get_socket_local_address_bytes(*sock_fd), first_addr_bytes);
+        ASSERT_EQ(get_socket_int_option(*sock_fd, SOL_SOCKET, SO_REUSEPORT), make_ok_result(1));
+        ASSERT_EQ(get_socket_int_option(*sock_fd, SOL_SOCKET, SO_ACCEPTCONN), make_ok_result(1));
+    }
+}
+
+
+TEST(NosyncNetUtils, OpenListeningSocketWithOptions)
+{
+    socket_options sock_opts;
+    sock_opts.tcp_nodelay = true;
+    sock_opts.recv_buffer_size = 65536;
+
+    auto sock_fd_res = open_listening_stream_socket(make_ipv4_localhost_socket_address(0)->get_view(), 4, sock_opts);
+    ASSERT_TRUE(sock_fd_res.is_ok());
+
+    const auto &sock_fd = sock_fd_res.get_value();
+    ASSERT_EQ(get_socket_int_option(*sock_fd, IPPROTO_TCP, TCP_NODELAY), make_ok_result(1));
+
+    auto recv_buffer_size_res = get_socket_int_option(*sock_fd, SOL_SOCKET, SO_RCVBUF);
+    ASSERT_TRUE(recv_buffer_size_res.is_ok());
+    ASSERT_GE(recv_buffer_size_res.get_value(), 65536);
+}
+
+
+TEST(NosyncNetUtils, ParseNumericIpAddresses)
+{
+    auto addr4_res = make_numeric_ip_socket_address("127.0.0.1", 1234);
+    ASSERT_TRUE(addr4_res.is_ok());
+    ASSERT_EQ(get_socket_address_bytes(*addr4_res.get_value()), get_socket_address_bytes(*make_ipv4_localhost_socket_address(1234)));
+
+    auto addr6_res = make_numeric_ip_socket_address("::1", 1234);
+    ASSERT_TRUE(addr6_res.is_ok());
+    ASSERT_EQ(get_socket_address_bytes(*addr6_res.get_value()), get_socket_address_bytes(*make_ipv6_localhost_socket_address(1234)));
+
+    auto scoped_addr6_res = make_numeric_ip_socket_address("[fe80::1%2]", 80);
+    ASSERT_TRUE(scoped_addr6_res.is_ok());
+    const auto scoped_addr6_view = scoped_addr6_res.get_value()->get_view();
+    ASSERT_EQ(scoped_addr6_res.get_value()->get_address_family(), AF_INET6);
+    ASSERT_EQ(reinterpret_cast<const sockaddr_in6 *>(scoped_addr6_view.addr)->sin6_scope_id, 2U);
+    ASSERT_EQ(reinterpret_cast<const sockaddr_in6 *>(scoped_addr6_view.addr)->sin6_port, htons(80));
+
+    for (const auto &bad_addr : {"", "localhost", "1.2.3", "::g", "fe80::1%", "fe80::1%eth0"}) {
+        ASSERT_FALSE(make_numeric_ip_socket_address(bad_addr, 0).is_ok());
+    }
+}
+
+
+TEST(NosyncNetUtils, ReceiveDatagramWithInlineAddress)
+{
+    auto recv_sock_res = open_bound_datagram_socket(make_ipv4_localhost_socket_address(0)->get_view());
+    ASSERT_TRUE(recv_sock_res.is_ok());
+    const auto &recv_sock = recv_sock_res.get_value();
+
+    auto recv_addr_res = get_socket_local_address(*recv_sock);
+    ASSERT_TRUE(recv_addr_res.is_ok());
+
+    auto send_sock_res = open_connected_datagram_socket(recv_addr_res.get_value()->get_view());
+    ASSERT_TRUE(send_sock_res.is_ok());
+    const auto &send_sock = send_sock_res.get_value();
+    ASSERT_EQ(::send(*send_sock, "abc", 3, 0), 3);
+
+    auto datagram_res = receive_datagram_via_socket(*recv_sock, 8);
+    ASSERT_TRUE(datagram_res.is_ok());
+    ASSERT_EQ(get<string>(datagram_res.get_value()), "abc");
+
+    const auto &src_addr = get<inline_socket_address>(datagram_res.get_value());
+    ASSERT_EQ(src_addr.get_address_family(), AF_INET);
+    ASSERT_EQ(get_socket_address_bytes(src_addr), get_socket_local_address_bytes(*send_sock));
+
+    inline_socket_address src_addr_copy = src_addr;
+    ASSERT_EQ(get_socket_address_bytes(src_addr_copy), get_socket_address_bytes(src_addr));
+
+    inline_socket_address assigned_addr;
+    assigned_addr = src_addr;
+    ASSERT_EQ(get_socket_address_bytes(assigned_addr), get_socket_address_bytes(src_addr));
+}
@@ -0,0 +1,254 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#include <cerrno>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <nosync/net-utils.h>
+#include <nosync/owned-fd.h>
+#include <nosync/pooling-socket-connections-bytes-io-requester.h>
+#include <nosync/ppoll-based-event-loop.h>
+#include <stdexcept>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+using namespace std::chrono_literals;
+using nosync::bytes_io;
+using nosync::make_local_abstract_socket_address;
+using nosync::make_pooling_socket_connections_bytes_io_requester;
+using nosync::make_ppoll_based_event_loop;
+using nosync::open_local_abstract_listening_stream_socket;
+using nosync::owned_fd;
+using nosync::socket_address;
+using nosync::socket_connections_pool_config;
+using std::move;
+using std::shared_ptr;
+using std::string;
+using std::to_string;
+using std::vector;
+
+
+namespace
+{
+
+vector<owned_fd> accept_pending_connections(int listen_sock_fd)
+{
+    vector<owned_fd> conn_fds;
+    for (;;) {
+        int accept_retval = ::accept4(listen_sock_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (accept_retval < 0) {
+            break;
+        }
+        conn_fds.emplace_back(accept_retval);
+    }
+
+    return conn_fds;
+}
+
+}
+
+
+TEST(NosyncPoolingSocketConnectionsBytesIoRequester, ReuseConnections)
+{
+    auto test_evloop = make_ppoll_based_event_loop();
+
+    const auto sock_path = "nosync-pool-test-" + to_string(::getpid());
+    auto listen_sock_res = open_local_abstract_listening_stream_socket(sock_path, 4);
+    ASSERT_TRUE(listen_sock_res.is_ok());
+    const auto &listen_sock = listen_sock_res.get_value();
+
+    auto addr_res = make_local_abstract_socket_address(sock_path);
+    ASSERT_TRUE(addr_res.is_ok());
+    shared_ptr<socket_address> addr = move(addr_res.get_value());
+
+    auto requester = make_pooling_socket_connections_bytes_io_requester(
+        *test_evloop, socket_connections_pool_config{1, 10ms});
+
+    vector<shared_ptr<bytes_io>> ios;
+    auto io_pusher = [&ios](auto io_res) {
+        ASSERT_TRUE(io_res.is_ok());
+        ios.push_back(move(io_res.get_value()));
+    };
+
+    requester->handle_request(shared_ptr<socket_address>(addr), 1s, io_pusher);
+    test_evloop->run_iterations();
+    ASSERT_EQ(ios.size(), 1U);
+
+    auto server_conns = accept_pending_connections(*listen_sock);
+    ASSERT_EQ(server_conns.size(), 1U);
+
+    requester->handle_request(shared_ptr<socket_address>(addr), 1s, io_pusher);
+    ios[0] = nullptr;
+    test_evloop->run_iterations();
+    ASSERT_EQ(ios.size(), 2U);
+    ASSERT_TRUE(accept_pending_connections(*listen_sock).empty());
+
+    ios[1] = nullptr;
+    requester->handle_request(shared_ptr<socket_address>(addr), 1s, io_pusher);
+    test_evloop->run_iterations();
+    ASSERT_EQ(ios.size(), 3U);
+    ASSERT_TRUE(accept_pending_connections(*listen_sock).empty());
+
+    server_conns.clear();
+    ios[2] = nullptr;
+    requester->handle_request(shared_ptr<socket_address>(addr), 1s, io_pusher);
+    test_evloop->run_iterations();
+    ASSERT_EQ(ios.size(), 4U);
+
+    server_conns = accept_pending_connections(*listen_sock);
+    ASSERT_EQ(server_conns.size(), 1U);
+
+    ios[3] = nullptr;
+    test_evloop->run_iterations();
+
+    char data;
+    ASSERT_EQ(::read(*server_conns[0], &data, 1), 0);
+}
+
+
+TEST(NosyncPoolingSocketConnectionsBytesIoRequester, WaitForReleasedConnection)
+{
+    auto test_evloop = make_ppoll_based_event_loop();
+
+    const auto sock_path = "nosync-pool-test-wait-" + to_string(::getpid());
+    auto listen_sock_res = open_local_abstract_listening_stream_socket(sock_path, 4);
+    ASSERT_TRUE(listen_sock_res.is_ok());
+    const auto &listen_sock = listen_sock_res.get_value();
+
+    auto addr_res = make_local_abstract_socket_address(sock_path);
+    ASSERT_TRUE(addr_res.is_ok());
+    shared_ptr<socket_address> addr = move(addr_res.get_value());
+
+    auto requester = make_pooling_socket_connections_bytes_io_requester(
+        *test_evloop, socket_connections_pool_config{1, 1s});
+
+    vector<shared_ptr<bytes_io>> ios;
+    auto io_pusher = [&ios](auto io_res) {
+        ASSERT_TRUE(io_res.is_ok());
+        ios.push_back(move(io_res.get_value()));
+    };
+
+    requester->handle_request(shared_ptr<socket_address>(addr), 1s, io_pusher);
+    test_evloop->run_iterations();
+    ASSERT_EQ(ios.size(), 1U);
+    auto server_conns = accept_pending_connections(*listen_sock);
+    ASSERT_EQ(server_conns.size(), 1U);
+
+    requester->handle_request(shared_ptr<socket_address>(addr), 1s, io_pusher);
+    ios[0] = nullptr;
+    test_evloop->run_iterations();
+    ASSERT_EQ(ios.size(), 2U);
+    ASSERT_TRUE(accept_pending_connections(*listen_sock).empty());
+
+    ASSERT_EQ(::write(*server_conns[0], "x", 1), 1);
+    requester->handle_request(shared_ptr<socket_address>(addr), 1s, io_pusher);
+    ios[1] = nullptr;
+    test_evloop->run_iterations();
+    ASSERT_EQ(ios.size(), 3U);
+    ASSERT_EQ(accept_pending_connections(*listen_sock).size(), 1U);
+
+    char data;
+    auto read_retval = ::read(*server_conns[0], &data, 1);
+    ASSERT_TRUE(read_retval == 0 || (read_retval < 0 && errno == ECONNRESET));
+}
+
+
+TEST(NosyncPoolingSocketConnectionsBytesIoRequester, AbandonedConnectionCountsUntilOpsFinish)
+{
+    auto test_evloop = make_ppoll_based_event_loop();
+
+    const auto sock_path = "nosync-pool-test-abandon-" + to_string(::getpid());
+    auto listen_sock_res = open_local_abstract_listening_stream_socket(sock_path, 4);
+    ASSERT_TRUE(listen_sock_res.is_ok());
+    const auto &listen_sock = listen_sock_res.get_value();
+
+    auto addr_res = make_local_abstract_socket_address(sock_path);
+    ASSERT_TRUE(addr_res.is_ok());
+    shared_ptr<socket_address> addr = move(addr_res.get_value());
+
+    auto requester = make_pooling_socket_connections_bytes_io_requester(
+        *test_evloop, socket_connections_pool_config{1, 1s});
+
+    vector<shared_ptr<bytes_io>> ios;
+    auto io_pusher = [&ios](auto io_res) {
+        ASSERT_TRUE(io_res.is_ok());
+        ios.push_back(move(io_res.get_value()));
+    };
+
+    requester->handle_request(shared_ptr<socket_address>(addr), 1s, io_pusher);
+    test_evloop->run_iterations();
+    ASSERT_EQ(ios.size(), 1U);
+    auto server_conns = accept_pending_connections(*listen_sock);
+    ASSERT_EQ(server_conns.size(), 1U);
+
+    vector<string> read_data;
+    ios[0]->read_some_bytes(
+        1, 1s,
+        [&read_data](auto read_res) {
+            ASSERT_TRUE(read_res.is_ok());
+            read_data.push_back(read_res.get_value());
+        });
+    ios[0] = nullptr;
+
+    requester->handle_request(shared_ptr<socket_address>(addr), 1s, io_pusher);
+    ASSERT_TRUE(accept_pending_connections(*listen_sock).empty());
+
+    ASSERT_EQ(::write(*server_conns[0], "x", 1), 1);
+    test_evloop->run_iterations();
+    ASSERT_EQ(read_data, vector<string>({"x"}));
+    ASSERT_EQ(ios.size(), 2U);
+    ASSERT_EQ(accept_pending_connections(*listen_sock).size(), 1U);
+}
+
+
+TEST(NosyncPoolingSocketConnectionsBytesIoRequester, EvictIdleConnections)
+{
+    auto test_evloop = make_ppoll_based_event_loop();
+
+    const auto sock_path = "nosync-pool-test-evict-" + to_string(::getpid());
+    auto listen_sock_res = open_local_abstract_listening_stream_socket(sock_path, 4);
+    ASSERT_TRUE(listen_sock_res.is_ok());
+    const auto &listen_sock = listen_sock_res.get_value();
+
+    auto addr_res = make_local_abstract_socket_address(sock_path);
+    ASSERT_TRUE(addr_res.is_ok());
+    shared_ptr<socket_address> addr = move(addr_res.get_value());
+
+    auto requester = make_pooling_socket_connections_bytes_io_requester(
+        *test_evloop, socket_connections_pool_config{2, 10ms});
+
+    vector<shared_ptr<bytes_io>> ios;
+    auto io_pusher = [&ios](auto io_res) {
+        ASSERT_TRUE(io_res.is_ok());
+        ios.push_back(move(io_res.get_value()));
+    };
+
+    requester->handle_request(shared_ptr<socket_address>(addr), 1s, io_pusher);
+    test_evloop->run_iterations();
+    ASSERT_EQ(ios.size(), 1U);
+    auto server_conns = accept_pending_connections(*listen_sock);
+    ASSERT_EQ(server_conns.size(), 1U);
+
+    ios[0] = nullptr;
+    test_evloop->run_iterations();
+
+    char data;
+    ASSERT_EQ(::read(*server_conns[0], &data, 1), 0);
+
+    requester->handle_request(shared_ptr<socket_address>(addr), 1s, io_pusher);
+    test_evloop->run_iterations();
+    ASSERT_EQ(ios.size(), 2U);
+    ASSERT_EQ(accept_pending_connections(*listen_sock).size(), 1U);
+}
+
+
+TEST(NosyncPoolingSocketConnectionsBytesIoRequester, ZeroConnectionsLimit)
+{
+    auto test_evloop = make_ppoll_based_event_loop();
+
+    ASSERT_THROW(
+        make_pooling_socket_connections_bytes_io_requester(*test_evloop, socket_connections_pool_config{0, 1s}),
+        std::invalid_argument);
+}
@@ -157,6 +157,42 @@ TEST(NosyncPpollBasedEventLoop, TestFdWatch)
 }
 
 
+TEST(NosyncPpollBasedEventLoop, TestFdErrorWatch)
+{
+    auto evloop = make_ppoll_based_event_loop();
+
+    int pipe_fds[2];
+    ASSERT_EQ(::pipe2(pipe_fds, O_CLOEXEC), 0);
+    unique_ptr<activity_handle> watch_handle;
+
+    auto exec_trace = ""s;
+
+    watch_handle = evloop->add_watch(
+        pipe_fds[1], fd_watch_mode::error,
+        [&]() {
+            exec_trace.push_back('E');
+            watch_handle->disable();
+        });
+    evloop->invoke_at(
+        evloop->get_etime(),
+        [&]() {
+            exec_trace.push_back('w');
+            ::write(pipe_fds[1], "", 1);
+            evloop->invoke_at(
+                evloop->get_etime() + small_time_increment,
+                [&]() {
+                    exec_trace.push_back('c');
+                    ::close(pipe_fds[0]);
+                });
+        });
+
+    ASSERT_EQ(exec_trace, ""s);
+    ASSERT_FALSE(evloop->run_iterations());
+    ASSERT_EQ(exec_trace, "wcE"s);
+
+    ::close(pipe_fds[1]);
+}
+
 TEST(NosyncPpollBasedEventLoop, TestQuitBetweenTasks)
 {
     auto evloop = make_ppoll_based_event_loop();
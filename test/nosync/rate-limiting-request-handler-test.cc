@@ -0,0 +1,75 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#include <chrono>
+#include <functional>
+#include <gtest/gtest.h>
+#include <memory>
+#include <nosync/func-request-handler.h>
+#include <nosync/manual-event-loop.h>
+#include <nosync/rate-limiting-request-handler.h>
+#include <nosync/result.h>
+#include <nosync/token-bucket.h>
+#include <nosync/type-utils.h>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace ch = std::chrono;
+using namespace std::chrono_literals;
+using nosync::eclock;
+using nosync::make_copy;
+using nosync::make_func_request_handler;
+using nosync::make_ok_result;
+using nosync::make_rate_limiting_request_handler;
+using nosync::make_timeout_error_result;
+using nosync::make_token_bucket;
+using nosync::manual_event_loop;
+using nosync::result;
+using std::make_tuple;
+using std::move;
+using std::tuple;
+using std::vector;
+
+
+TEST(NosyncRateLimitingRequestHandler, BurstAndSharedBucket)
+{
+    auto evloop = manual_event_loop::create();
+    const auto start_time = evloop->get_etime();
+
+    vector<tuple<int, ch::time_point<eclock>>> base_requests;
+    auto base_handler = make_func_request_handler<int, int>(
+        [&](auto &&req, auto, auto &&res_handler) {
+            base_requests.emplace_back(req, evloop->get_etime());
+            res_handler(make_ok_result(req));
+        });
+
+    auto bucket = make_token_bucket(*evloop, 10ns, 2);
+    auto handler_a = make_rate_limiting_request_handler<int, int>(*evloop, bucket, make_copy(base_handler));
+    auto handler_b = make_rate_limiting_request_handler<int, int>(*evloop, bucket, make_copy(base_handler));
+
+    vector<result<int>> results;
+    auto result_pusher = [&results](auto res) {
+        results.push_back(move(res));
+    };
+
+    handler_a->handle_request(1, 100ns, result_pusher);
+    handler_b->handle_request(2, 100ns, result_pusher);
+    handler_a->handle_request(3, 100ns, result_pusher);
+    handler_b->handle_request(4, 5ns, result_pusher);
+    handler_a->handle_request(5, 100ns, result_pusher);
+    ASSERT_EQ(base_requests.size(), 2U);
+
+    for (unsigned i = 0; i < 30; ++i) {
+        evloop->process_time_passage(1ns);
+    }
+
+    ASSERT_EQ(
+        base_requests,
+        (vector<tuple<int, ch::time_point<eclock>>>({
+            make_tuple(1, start_time),
+            make_tuple(2, start_time),
+            make_tuple(3, start_time + 10ns),
+            make_tuple(5, start_time + 20ns),
+        })));
+    ASSERT_EQ(results.size(), 5U);
+    ASSERT_EQ(results[2], make_timeout_error_result<int>());
+}
@@ -6,11 +6,13 @@
 #include <memory>
 #include <nosync/activity-handle-mock.h>
 #include <nosync/event-loop-mock.h>
+#include <nosync/manual-event-loop.h>
 #include <nosync/requests-queue.h>
 #include <nosync/type-utils.h>
 #include <stdexcept>
 #include <string>
 #include <system_error>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -24,17 +26,24 @@ using nosync::make_copy;
 using nosync::make_error_result;
 using nosync::make_ok_result;
 using nosync::make_timeout_error_result;
+using nosync::manual_event_loop;
 using nosync::requests_queue;
+using nosync::requests_queue_capacity;
+using nosync::requests_queue_overflow_policy;
 using nosync::result;
 using std::errc;
 using std::function;
 using std::get;
 using std::logic_error;
 using std::make_error_code;
+using std::make_shared;
 using std::make_unique;
 using std::move;
+using std::shared_ptr;
 using std::string;
+using std::tuple;
 using std::vector;
+using std::weak_ptr;
 using testing::_;
 using testing::Eq;
 using testing::Invoke;
@@ -194,3 +203,136 @@ TEST(NosyncRequestsQueue, CheckCancelOnDestroy)
     ASSERT_EQ(results.size(), 1U);
     ASSERT_EQ(results.front(), make_error_result<string>(make_error_code(errc::operation_canceled)));
 }
+
+
+TEST(NosyncRequestsQueue, MixedTimeouts)
+{
+    auto evloop = manual_event_loop::create();
+
+    vector<result<string>> results;
+    auto result_pusher = [&results](auto result) {
+        results.push_back(move(result));
+    };
+
+    auto req_queue = make_unique<requests_queue<unsigned, string>>(*evloop);
+
+    const auto start_time = evloop->get_etime();
+    for (auto req_timeout : {5ns, 2ns, 7ns, 2ns, 1ns, 9ns, 3ns}) {
+        req_queue->push_request(req_timeout.count(), start_time + req_timeout, result_pusher);
+    }
+
+    ASSERT_EQ(get<unsigned>(req_queue->pull_next_request()), 5U);
+
+    evloop->process_time_passage(2ns);
+    ASSERT_EQ(results, vector<result<string>>(3, make_timeout_error_result<string>()));
+
+    ASSERT_EQ(get<unsigned>(req_queue->pull_next_request()), 7U);
+
+    evloop->process_time_passage(2ns);
+    ASSERT_EQ(results.size(), 4U);
+
+    ASSERT_EQ(get<unsigned>(req_queue->pull_next_request()), 9U);
+    ASSERT_FALSE(req_queue->has_requests());
+
+    evloop->process_time_passage(10ns);
+    ASSERT_EQ(results.size(), 4U);
+}
+
+
+TEST(NosyncRequestsQueue, OverflowPolicies)
+{
+    auto evloop = manual_event_loop::create();
+
+    const auto overload_error = make_error_result<string>(make_error_code(errc::resource_unavailable_try_again));
+
+    for (auto policy : {requests_queue_overflow_policy::reject_newest, requests_queue_overflow_policy::drop_oldest, requests_queue_overflow_policy::drop_expiring}) {
+        vector<tuple<unsigned, result<string>>> results;
+        auto make_result_pusher = [&results](unsigned req_no) {
+            return [&results, req_no](auto result) {
+                results.emplace_back(req_no, move(result));
+            };
+        };
+
+        auto req_queue = make_unique<requests_queue<unsigned, string>>(*evloop, requests_queue_capacity{2, policy, 5ns});
+
+        const auto now = evloop->get_etime();
+        req_queue->push_request(1U, now + 10ns, make_result_pusher(1));
+        req_queue->push_request(2U, now + 3ns, make_result_pusher(2));
+        req_queue->push_request(3U, now + 10ns, make_result_pusher(3));
+        ASSERT_EQ(req_queue->get_requests_count(), 2U);
+        ASSERT_TRUE(results.empty());
+
+        evloop->process_time_passage(0ns);
+        ASSERT_EQ(results.size(), 1U);
+        ASSERT_EQ(get<1>(results.front()), overload_error);
+
+        const auto dropped_req_no = get<0>(results.front());
+        const auto first_pulled_req_no = get<unsigned>(req_queue->pull_next_request());
+        switch (policy) {
+        case requests_queue_overflow_policy::reject_newest:
+            ASSERT_EQ(dropped_req_no, 3U);
+            ASSERT_EQ(first_pulled_req_no, 1U);
+            break;
+        case requests_queue_overflow_policy::drop_oldest:
+            ASSERT_EQ(dropped_req_no, 1U);
+            ASSERT_EQ(first_pulled_req_no, 2U);
+            break;
+        case requests_queue_overflow_policy::drop_expiring:
+            ASSERT_EQ(dropped_req_no, 2U);
+            ASSERT_EQ(first_pulled_req_no, 1U);
+            break;
+        }
+
+        ASSERT_EQ(req_queue->get_requests_count(), 1U);
+        req_queue.reset();
+        evloop->process_time_passage(0ns);
+    }
+}
+
+
+TEST(NosyncRequestsQueue, TimeoutsBehindLongLivedRequest)
+{
+    auto evloop = manual_event_loop::create();
+
+    vector<result<string>> results;
+    auto result_pusher = [&results](auto result) {
+        results.push_back(move(result));
+    };
+
+    auto req_queue = make_unique<requests_queue<shared_ptr<unsigned>, string>>(*evloop);
+
+    const auto start_time = evloop->get_etime();
+    req_queue->push_request(make_shared<unsigned>(0U), start_time + 1000ns, result_pusher);
+
+    vector<weak_ptr<unsigned>> timeouted_reqs;
+    vector<unsigned> kept_reqs;
+    for (unsigned i = 1; i <= 100; ++i) {
+        if (i % 10 == 0) {
+            req_queue->push_request(make_shared<unsigned>(i), start_time + 2000ns - ch::nanoseconds(i), result_pusher);
+            kept_reqs.push_back(i);
+        }
+
+        auto req = make_shared<unsigned>(i);
+        timeouted_reqs.push_back(req);
+        req_queue->push_request(move(req), evloop->get_etime() + 1ns, result_pusher);
+        evloop->process_time_passage(1ns);
+    }
+
+    ASSERT_EQ(results, vector<result<string>>(100, make_timeout_error_result<string>()));
+    for (const auto &req : timeouted_reqs) {
+        ASSERT_TRUE(req.expired());
+    }
+    ASSERT_EQ(req_queue->get_requests_count(), 1U + kept_reqs.size());
+
+    ASSERT_EQ(*get<shared_ptr<unsigned>>(req_queue->pull_next_request()), 0U);
+
+    evloop->process_time_passage(start_time + 1905ns - evloop->get_etime());
+    ASSERT_EQ(results.size(), 101U);
+
+    for (auto kept_req : kept_reqs) {
+        if (kept_req != 100) {
+            ASSERT_EQ(*get<shared_ptr<unsigned>>(req_queue->pull_next_request()), kept_req);
+        }
+    }
+    ASSERT_FALSE(req_queue->has_requests());
+}
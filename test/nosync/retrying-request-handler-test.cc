@@ -0,0 +1,189 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#include <chrono>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <memory>
+#include <nosync/func-request-handler.h>
+#include <nosync/manual-event-loop.h>
+#include <nosync/result.h>
+#include <nosync/retrying-request-handler.h>
+#include <system_error>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace std::chrono_literals;
+using nosync::make_error_result;
+using nosync::make_func_request_handler;
+using nosync::make_ok_result;
+using nosync::make_retrying_request_handler;
+using nosync::manual_event_loop;
+using nosync::result;
+using nosync::result_handler;
+using nosync::retrying_request_handler_config;
+using std::chrono::nanoseconds;
+using std::errc;
+using std::make_error_code;
+using std::move;
+using std::tuple;
+using std::vector;
+
+
+TEST(NosyncRetryingRequestHandler, RetryWithBackoff)
+{
+    auto evloop = manual_event_loop::create();
+
+    vector<tuple<int, nanoseconds, result_handler<int>>> base_requests;
+    auto retrying_handler = make_retrying_request_handler<int, int>(
+        *evloop, retrying_request_handler_config{{make_error_code(errc::resource_unavailable_try_again)}, 10ns, 15ns, 2.0, 2.0, 10.0, 0.0},
+        make_func_request_handler<int, int>(
+            [&base_requests](auto &&req, auto timeout, auto &&res_handler) {
+                base_requests.emplace_back(req, timeout, move(res_handler));
+            }));
+
+    vector<result<int>> results;
+    auto result_pusher = [&results](auto res) {
+        results.push_back(move(res));
+    };
+
+    retrying_handler->handle_request(7, 100ns, result_pusher);
+    ASSERT_EQ(base_requests.size(), 1U);
+
+    std::get<result_handler<int>>(base_requests[0])(make_error_result<int>(errc::resource_unavailable_try_again));
+    evloop->process_time_passage(4ns);
+    ASSERT_EQ(base_requests.size(), 1U);
+    evloop->process_time_passage(6ns);
+    ASSERT_EQ(base_requests.size(), 2U);
+    ASSERT_EQ(std::get<int>(base_requests[1]), 7);
+    ASSERT_GE(std::get<nanoseconds>(base_requests[1]), 90ns);
+    ASSERT_LE(std::get<nanoseconds>(base_requests[1]), 95ns);
+
+    std::get<result_handler<int>>(base_requests[1])(make_error_result<int>(errc::resource_unavailable_try_again));
+    evloop->process_time_passage(6ns);
+    ASSERT_EQ(base_requests.size(), 2U);
+    evloop->process_time_passage(9ns);
+    ASSERT_EQ(base_requests.size(), 3U);
+    ASSERT_TRUE(results.empty());
+
+    std::get<result_handler<int>>(base_requests[2])(make_error_result<int>(errc::invalid_argument));
+    ASSERT_EQ(results, vector<result<int>>({make_error_result<int>(errc::invalid_argument)}));
+
+    evloop->process_time_passage(100ns);
+    ASSERT_EQ(base_requests.size(), 3U);
+}
+
+
+TEST(NosyncRetryingRequestHandler, TimeoutAndBudgetLimits)
+{
+    auto evloop = manual_event_loop::create();
+
+    vector<result_handler<int>> base_requests;
+    auto retrying_handler = make_retrying_request_handler<int, int>(
+        *evloop, retrying_request_handler_config{{make_error_code(errc::resource_unavailable_try_again)}, 10ns, 10ns, 1.0, 0.5, 1.0, 0.0},
+        make_func_request_handler<int, int>(
+            [&base_requests](auto &&, auto, auto &&res_handler) {
+                base_requests.push_back(move(res_handler));
+            }));
+
+    vector<result<int>> results;
+    auto result_pusher = [&results](auto res) {
+        results.push_back(move(res));
+    };
+
+    retrying_handler->handle_request(1, 100ns, result_pusher);
+    base_requests[0](make_error_result<int>(errc::resource_unavailable_try_again));
+    ASSERT_EQ(results, vector<result<int>>({make_error_result<int>(errc::resource_unavailable_try_again)}));
+
+    retrying_handler->handle_request(2, 5ns, result_pusher);
+    base_requests[1](make_error_result<int>(errc::resource_unavailable_try_again));
+    ASSERT_EQ(results.size(), 2U);
+
+    retrying_handler->handle_request(3, 100ns, result_pusher);
+    base_requests[2](make_error_result<int>(errc::resource_unavailable_try_again));
+    evloop->process_time_passage(10ns);
+    ASSERT_EQ(base_requests.size(), 4U);
+    ASSERT_EQ(results.size(), 2U);
+
+    base_requests[3](make_ok_result(3));
+    ASSERT_EQ(results.size(), 3U);
+    ASSERT_EQ(results[2], make_ok_result(3));
+}
+
+
+TEST(NosyncRetryingRequestHandler, InitialBudgetAndSeededJitter)
+{
+    auto record_retry_delays = [](std::uint_fast32_t random_seed) {
+        auto evloop = manual_event_loop::create();
+
+        vector<result_handler<int>> base_requests;
+        auto retrying_handler = make_retrying_request_handler<int, int>(
+            *evloop, retrying_request_handler_config{{make_error_code(errc::resource_unavailable_try_again)}, 100ns, 100ns, 1.0, 0.0, 3.0, 5.0},
+            make_func_request_handler<int, int>(
+                [&base_requests](auto &&, auto, auto &&res_handler) {
+                    base_requests.push_back(move(res_handler));
+                }),
+            random_seed);
+
+        vector<result<int>> results;
+        retrying_handler->handle_request(
+            1, 10000ns,
+            [&results](auto res) {
+                results.push_back(move(res));
+            });
+
+        vector<nanoseconds> retry_delays;
+        for (;;) {
+            base_requests.back()(make_error_result<int>(errc::resource_unavailable_try_again));
+            if (!results.empty()) {
+                break;
+            }
+
+            const auto requests_count = base_requests.size();
+            nanoseconds retry_delay(0);
+            while (base_requests.size() == requests_count) {
+                evloop->process_time_passage(1ns);
+                retry_delay += 1ns;
+            }
+
+            EXPECT_GE(retry_delay, 50ns);
+            EXPECT_LE(retry_delay, 100ns);
+            retry_delays.push_back(retry_delay);
+        }
+
+        return retry_delays;
+    };
+
+    const auto retry_delays = record_retry_delays(7U);
+    ASSERT_EQ(retry_delays.size(), 3U);
+    ASSERT_EQ(record_retry_delays(7U), retry_delays);
+}
+
+
+TEST(NosyncRetryingRequestHandler, DropResultsAfterDestroy)
+{
+    auto evloop = manual_event_loop::create();
+
+    vector<result_handler<int>> base_requests;
+    auto retrying_handler = make_retrying_request_handler<int, int>(
+        *evloop, retrying_request_handler_config{{make_error_code(errc::resource_unavailable_try_again)}, 10ns, 10ns, 1.0, 0.0, 10.0, 10.0},
+        make_func_request_handler<int, int>(
+            [&base_requests](auto &&, auto, auto &&res_handler) {
+                base_requests.push_back(move(res_handler));
+            }));
+
+    vector<result<int>> results;
+    auto result_pusher = [&results](auto res) {
+        results.push_back(move(res));
+    };
+
+    retrying_handler->handle_request(1, 100ns, result_pusher);
+    retrying_handler->handle_request(2, 100ns, result_pusher);
+    ASSERT_EQ(base_requests.size(), 2U);
+    base_requests[0](make_error_result<int>(errc::resource_unavailable_try_again));
+
+    retrying_handler.reset();
+    base_requests[1](make_ok_result(2));
+    evloop->process_time_passage(100ns);
+    ASSERT_EQ(base_requests.size(), 2U);
+    ASSERT_TRUE(results.empty());
+}
@@ -11,6 +11,7 @@
 #include <nosync/owned-fd.h>
 #include <nosync/result.h>
 #include <nosync/socket-connections-fd-acceptor.h>
+#include <stdexcept>
 #include <string>
 #include <sys/socket.h>
 #include <sys/un.h>
@@ -24,10 +25,13 @@ using nosync::activity_handle_mock;
 using nosync::fd_watch_mode;
 using nosync::make_error_result;
 using nosync::fd_watcher_mock;
+using nosync::make_draining_socket_connections_fd_acceptor;
 using nosync::make_full_socket_connections_fd_acceptor;
 using nosync::make_socket_connections_fd_acceptor;
 using nosync::owned_fd;
 using nosync::shared_fd;
+using nosync::socket_address;
+using nosync::socket_options;
 using std::array;
 using std::error_code;
 using std::experimental::make_array;
@@ -38,6 +42,7 @@ using std::make_unique;
 using std::move;
 using std::size_t;
 using std::string;
+using std::unique_ptr;
 using std::vector;
 using std::weak_ptr;
 using testing::_;
@@ -48,7 +53,7 @@ using testing::Invoke;
 namespace
 {
 
-owned_fd make_listening_unix_socket()
+owned_fd make_listening_unix_socket(int backlog_size = 1)
 {
     int sock_fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
     if (sock_fd < 0) {
@@ -59,7 +64,7 @@ owned_fd make_listening_unix_socket()
     addr.sun_family = AF_UNIX;
 
     if (::bind(sock_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(sa_family_t)) < 0
-        || ::listen(sock_fd, 1) < 0) {
+        || ::listen(sock_fd, backlog_size) < 0) {
         (void) close(sock_fd);
         return {};
     }
@@ -275,3 +280,117 @@ TEST(NosyncSocketConnectionsFdAcceptor, CheckAcceptFailure)
 
     acceptor.reset();
 }
+
+
+TEST(NosyncSocketConnectionsFdAcceptor, CheckAcceptWithSocketOptions)
+{
+    auto listen_sock_fd = make_listening_unix_socket(2);
+    ASSERT_TRUE(listen_sock_fd);
+    auto listen_sock_name = get_unix_socket_name(*listen_sock_fd);
+    ASSERT_FALSE(listen_sock_name.empty());
+
+    function<void()> saved_sock_watch_notify_func;
+    auto mock_sock_watch_handle = make_unique<activity_handle_mock>();
+    EXPECT_CALL(*mock_sock_watch_handle, disable()).WillOnce(Invoke(
+        [&saved_sock_watch_notify_func]() {
+            saved_sock_watch_notify_func = nullptr;
+        }));
+
+    auto mock_watcher = make_shared<fd_watcher_mock>();
+    EXPECT_CALL(*mock_watcher, add_watch_impl(_, Eq(fd_watch_mode::input), _)).WillOnce(Invoke(
+        [&](auto, auto, auto notify_func) {
+            saved_sock_watch_notify_func = move(notify_func);
+            return move(mock_sock_watch_handle);
+        }));
+
+    socket_options conn_sock_opts;
+    conn_sock_opts.tcp_nodelay = true;
+
+    auto saved_conn_res = make_error_result<shared_fd>(error_code());
+
+    auto acceptor = make_full_socket_connections_fd_acceptor(
+        *mock_watcher, move(listen_sock_fd), conn_sock_opts,
+        [&](auto conn_res) {
+            saved_conn_res = move(conn_res);
+        });
+
+    auto client_sock_fd = make_connected_unix_socket(listen_sock_name);
+    ASSERT_TRUE(client_sock_fd);
+
+    saved_sock_watch_notify_func();
+    ASSERT_FALSE(saved_conn_res.is_ok());
+    ASSERT_NE(saved_conn_res.get_error(), error_code());
+
+    array<char, 1> eof_read_buf;
+    int eof_read_retval = read_nointr(*client_sock_fd, eof_read_buf.data(), eof_read_buf.size());
+    ASSERT_EQ(eof_read_retval, 0);
+
+    acceptor.reset();
+}
+
+
+TEST(NosyncSocketConnectionsFdAcceptor, CheckDrainingAccept)
+{
+    auto listen_sock_fd = make_listening_unix_socket(3);
+    ASSERT_TRUE(listen_sock_fd);
+    auto listen_sock_fd_no = *listen_sock_fd;
+    auto listen_sock_name = get_unix_socket_name(*listen_sock_fd);
+    ASSERT_FALSE(listen_sock_name.empty());
+
+    function<void()> saved_sock_watch_notify_func;
+    auto mock_sock_watch_handle = make_unique<activity_handle_mock>();
+    EXPECT_CALL(*mock_sock_watch_handle, disable()).WillOnce(Invoke(
+        [&saved_sock_watch_notify_func]() {
+            saved_sock_watch_notify_func = nullptr;
+        }));
+
+    auto mock_watcher = make_shared<fd_watcher_mock>();
+    EXPECT_CALL(*mock_watcher, add_watch_impl(Eq(listen_sock_fd_no), Eq(fd_watch_mode::input), _)).WillOnce(Invoke(
+        [&](auto, auto, auto notify_func) {
+            saved_sock_watch_notify_func = move(notify_func);
+            return move(mock_sock_watch_handle);
+        }));
+
+    vector<shared_fd> saved_conn_fds;
+
+    auto acceptor = make_draining_socket_connections_fd_acceptor(
+        *mock_watcher, move(listen_sock_fd), 2,
+        [&saved_conn_fds](auto conn_fd, auto peer_addr) {
+            ASSERT_TRUE(peer_addr);
+            ASSERT_EQ(peer_addr->get_address_family(), AF_UNIX);
+            saved_conn_fds.push_back(move(conn_fd));
+        });
+
+    ASSERT_TRUE(saved_sock_watch_notify_func);
+
+    vector<owned_fd> client_sock_fds;
+    for (int i = 0; i < 3; ++i) {
+        client_sock_fds.push_back(make_connected_unix_socket(listen_sock_name));
+        ASSERT_TRUE(client_sock_fds.back());
+    }
+
+    saved_sock_watch_notify_func();
+    ASSERT_EQ(saved_conn_fds.size(), 2U);
+
+    saved_sock_watch_notify_func();
+    ASSERT_EQ(saved_conn_fds.size(), 3U);
+
+    saved_sock_watch_notify_func();
+    ASSERT_EQ(saved_conn_fds.size(), 3U);
+
+    acceptor.reset();
+}
+
+
+TEST(NosyncSocketConnectionsFdAcceptor, CheckDrainingZeroMaxAccepts)
+{
+    auto listen_sock_fd = make_listening_unix_socket();
+    ASSERT_TRUE(listen_sock_fd);
+
+    auto mock_watcher = make_shared<fd_watcher_mock>();
+    EXPECT_CALL(*mock_watcher, add_watch_impl(_, _, _)).Times(0);
+
+    ASSERT_THROW(
+        make_draining_socket_connections_fd_acceptor(*mock_watcher, move(listen_sock_fd), 0, [](auto, auto) {}),
+        std::invalid_argument);
+}
@@ -0,0 +1,180 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <nosync/net-utils.h>
+#include <nosync/ppoll-based-event-loop.h>
+#include <nosync/shared-fd.h>
+#include <nosync/socket-connections-fd-requester.h>
+#include <string>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace ch = std::chrono;
+using namespace std::chrono_literals;
+using nosync::get_socket_local_address;
+using nosync::make_ipv4_localhost_socket_address;
+using nosync::make_local_abstract_socket_address;
+using nosync::make_ppoll_based_event_loop;
+using nosync::open_listening_stream_socket;
+using nosync::open_local_abstract_listening_stream_socket;
+using nosync::request_first_socket_connection_fd;
+using nosync::request_socket_connection_fd;
+using nosync::result;
+using nosync::shared_fd;
+using nosync::socket_address;
+using std::errc;
+using std::make_error_code;
+using std::move;
+using std::shared_ptr;
+using std::to_string;
+using std::vector;
+
+
+namespace
+{
+
+shared_ptr<socket_address> make_test_socket_address(const std::string &sock_path)
+{
+    auto addr_res = make_local_abstract_socket_address(sock_path);
+    EXPECT_TRUE(addr_res.is_ok());
+    return move(addr_res.get_value());
+}
+
+}
+
+
+TEST(NosyncSocketConnectionsFdRequester, FirstConnectionAfterFailedAttempt)
+{
+    auto test_evloop = make_ppoll_based_event_loop();
+
+    const auto sock_path_prefix = "nosync-fd-requester-test-" + to_string(::getpid());
+    auto listen_sock_res = open_local_abstract_listening_stream_socket(sock_path_prefix + "-listening", 4);
+    ASSERT_TRUE(listen_sock_res.is_ok());
+
+    vector<result<shared_fd>> saved_results;
+    request_first_socket_connection_fd(
+        *test_evloop,
+        {make_test_socket_address(sock_path_prefix + "-missing"), make_test_socket_address(sock_path_prefix + "-listening")},
+        1s, 1s,
+        [&saved_results](auto sock_res) {
+            saved_results.push_back(move(sock_res));
+        });
+
+    test_evloop->run_iterations();
+
+    ASSERT_EQ(saved_results.size(), 1U);
+    ASSERT_TRUE(saved_results.front().is_ok());
+    ASSERT_GE(*saved_results.front().get_value(), 0);
+}
+
+
+TEST(NosyncSocketConnectionsFdRequester, FirstConnectionAllAttemptsFailed)
+{
+    auto test_evloop = make_ppoll_based_event_loop();
+
+    const auto sock_path_prefix = "nosync-fd-requester-test-" + to_string(::getpid());
+
+    vector<result<shared_fd>> saved_results;
+    request_first_socket_connection_fd(
+        *test_evloop,
+        {make_test_socket_address(sock_path_prefix + "-missing1"), make_test_socket_address(sock_path_prefix + "-missing2")},
+        1s, 1s,
+        [&saved_results](auto sock_res) {
+            saved_results.push_back(move(sock_res));
+        });
+
+    test_evloop->run_iterations();
+
+    ASSERT_EQ(saved_results.size(), 1U);
+    ASSERT_FALSE(saved_results.front().is_ok());
+    ASSERT_EQ(saved_results.front().get_error(), make_error_code(errc::connection_refused));
+
+    saved_results.clear();
+    request_first_socket_connection_fd(
+        *test_evloop, {}, 1s, 1s,
+        [&saved_results](auto sock_res) {
+            saved_results.push_back(move(sock_res));
+        });
+
+    test_evloop->run_iterations();
+
+    ASSERT_EQ(saved_results.size(), 1U);
+    ASSERT_EQ(saved_results.front().get_error(), make_error_code(errc::invalid_argument));
+}
+
+
+TEST(NosyncSocketConnectionsFdRequester, FirstConnectionCancelsPendingAttempts)
+{
+    auto test_evloop = make_ppoll_based_event_loop();
+
+    auto tcp_listen_sock_res = open_listening_stream_socket(make_ipv4_localhost_socket_address(0)->get_view(), 0);
+    ASSERT_TRUE(tcp_listen_sock_res.is_ok());
+    auto tcp_listen_addr_res = get_socket_local_address(*tcp_listen_sock_res.get_value());
+    ASSERT_TRUE(tcp_listen_addr_res.is_ok());
+    shared_ptr<socket_address> tcp_listen_addr = move(tcp_listen_addr_res.get_value());
+
+    vector<result<shared_fd>> backlog_filling_results;
+    for (int i = 0; i < 2; ++i) {
+        request_socket_connection_fd(
+            *test_evloop, tcp_listen_addr, 10ms,
+            [&backlog_filling_results](auto sock_res) {
+                backlog_filling_results.push_back(move(sock_res));
+            });
+    }
+    test_evloop->run_iterations();
+    ASSERT_EQ(backlog_filling_results.size(), 2U);
+    ASSERT_TRUE(backlog_filling_results[0].is_ok());
+    if (backlog_filling_results[1].is_ok()) {
+        GTEST_SKIP() << "connection backlog not limited";
+    }
+
+    const auto sock_path = "nosync-fd-requester-test-" + to_string(::getpid()) + "-cancel";
+    auto listen_sock_res = open_local_abstract_listening_stream_socket(sock_path, 4);
+    ASSERT_TRUE(listen_sock_res.is_ok());
+
+    vector<result<shared_fd>> saved_results;
+    const auto start_time = ch::steady_clock::now();
+    request_first_socket_connection_fd(
+        *test_evloop, {tcp_listen_addr, make_test_socket_address(sock_path)}, 1ms, 10s,
+        [&saved_results](auto sock_res) {
+            saved_results.push_back(move(sock_res));
+        });
+
+    test_evloop->run_iterations();
+
+    ASSERT_EQ(saved_results.size(), 1U);
+    ASSERT_TRUE(saved_results.front().is_ok());
+    ASSERT_LT(ch::steady_clock::now() - start_time, 1s);
+}
+
+
+TEST(NosyncSocketConnectionsFdRequester, FirstConnectionTimeout)
+{
+    auto test_evloop = make_ppoll_based_event_loop();
+
+    auto tcp_listen_sock_res = open_listening_stream_socket(make_ipv4_localhost_socket_address(0)->get_view(), 0);
+    ASSERT_TRUE(tcp_listen_sock_res.is_ok());
+    auto tcp_listen_addr_res = get_socket_local_address(*tcp_listen_sock_res.get_value());
+    ASSERT_TRUE(tcp_listen_addr_res.is_ok());
+    shared_ptr<socket_address> tcp_listen_addr = move(tcp_listen_addr_res.get_value());
+
+    vector<result<shared_fd>> saved_results;
+    auto result_pusher = [&saved_results](auto sock_res) {
+        saved_results.push_back(move(sock_res));
+    };
+
+    request_socket_connection_fd(*test_evloop, tcp_listen_addr, 10ms, result_pusher);
+    test_evloop->run_iterations();
+    ASSERT_EQ(saved_results.size(), 1U);
+    ASSERT_TRUE(saved_results.front().is_ok());
+
+    request_first_socket_connection_fd(*test_evloop, {tcp_listen_addr, tcp_listen_addr}, 5ms, 20ms, result_pusher);
+    test_evloop->run_iterations();
+
+    ASSERT_EQ(saved_results.size(), 2U);
+    ASSERT_FALSE(saved_results.back().is_ok());
+    ASSERT_EQ(saved_results.back().get_error(), make_error_code(errc::timed_out));
+}
@@ -0,0 +1,205 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#include <functional>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <nosync/activity-handle-mock.h>
+#include <nosync/fd-watcher-mock.h>
+#include <nosync/owned-fd.h>
+#include <nosync/socket-datagrams-acceptor.h>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <sys/socket.h>
+#include <tuple>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+using namespace std::string_literals;
+using nosync::activity_handle_mock;
+using nosync::fd_watch_mode;
+using nosync::fd_watcher_mock;
+using nosync::interface_type;
+using nosync::make_batched_socket_datagrams_acceptor;
+using nosync::make_full_batched_socket_datagrams_acceptor;
+using nosync::owned_fd;
+using std::errc;
+using std::error_code;
+using std::function;
+using std::make_error_code;
+using std::make_shared;
+using std::make_unique;
+using std::move;
+using std::shared_ptr;
+using std::string;
+using std::tuple;
+using std::vector;
+using testing::_;
+using testing::Eq;
+using testing::Invoke;
+
+
+TEST(NosyncSocketDatagramsAcceptor, CheckBatchedReceive)
+{
+    int sock_fds[2];
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, sock_fds), 0);
+    owned_fd recv_sock_fd(sock_fds[0]);
+    owned_fd send_sock_fd(sock_fds[1]);
+    auto recv_sock_fd_no = *recv_sock_fd;
+
+    function<void()> saved_sock_watch_notify_func;
+    auto mock_sock_watch_handle = make_unique<activity_handle_mock>();
+    EXPECT_CALL(*mock_sock_watch_handle, disable()).WillOnce(Invoke(
+        [&saved_sock_watch_notify_func]() {
+            saved_sock_watch_notify_func = nullptr;
+        }));
+
+    auto mock_watcher = make_shared<fd_watcher_mock>();
+    EXPECT_CALL(*mock_watcher, add_watch_impl(Eq(recv_sock_fd_no), Eq(fd_watch_mode::input), _)).WillOnce(Invoke(
+        [&](auto, auto, auto notify_func) {
+            saved_sock_watch_notify_func = move(notify_func);
+            return move(mock_sock_watch_handle);
+        }));
+
+    vector<vector<string>> saved_batches;
+
+    auto acceptor = make_batched_socket_datagrams_acceptor(
+        *mock_watcher, move(recv_sock_fd), 4, 2,
+        [&saved_batches](auto datagrams) {
+            vector<string> batch;
+            for (auto &datagram : datagrams) {
+                batch.push_back(move(std::get<string>(datagram)));
+            }
+            saved_batches.push_back(move(batch));
+        });
+
+    ASSERT_TRUE(saved_sock_watch_notify_func);
+
+    for (const auto &data : {"ab"s, "toolong"s, "cdef"s, "g"s}) {
+        ASSERT_EQ(::write(*send_sock_fd, data.data(), data.size()), static_cast<ssize_t>(data.size()));
+    }
+
+    saved_sock_watch_notify_func();
+    saved_sock_watch_notify_func();
+    saved_sock_watch_notify_func();
+
+    ASSERT_EQ(saved_batches.size(), 2U);
+    ASSERT_EQ(saved_batches[0], vector<string>({"ab"}));
+    ASSERT_EQ(saved_batches[1], vector<string>({"cdef", "g"}));
+
+    acceptor.reset();
+}
+
+
+TEST(NosyncSocketDatagramsAcceptor, CheckBatchedReceiveReportsOversized)
+{
+    int sock_fds[2];
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, sock_fds), 0);
+    owned_fd recv_sock_fd(sock_fds[0]);
+    owned_fd send_sock_fd(sock_fds[1]);
+
+    function<void()> saved_sock_watch_notify_func;
+    auto mock_sock_watch_handle = make_unique<activity_handle_mock>();
+    EXPECT_CALL(*mock_sock_watch_handle, disable()).WillOnce(Invoke(
+        [&saved_sock_watch_notify_func]() {
+            saved_sock_watch_notify_func = nullptr;
+        }));
+
+    auto mock_watcher = make_shared<fd_watcher_mock>();
+    EXPECT_CALL(*mock_watcher, add_watch_impl(_, Eq(fd_watch_mode::input), _)).WillOnce(Invoke(
+        [&](auto, auto, auto notify_func) {
+            saved_sock_watch_notify_func = move(notify_func);
+            return move(mock_sock_watch_handle);
+        }));
+
+    vector<vector<string>> saved_batches;
+    vector<error_code> saved_errors;
+
+    auto acceptor = make_full_batched_socket_datagrams_acceptor(
+        *mock_watcher, move(recv_sock_fd), 4, 2,
+        [&saved_batches, &saved_errors](auto datagrams_res) {
+            if (!datagrams_res.is_ok()) {
+                saved_errors.push_back(datagrams_res.get_error());
+                return;
+            }
+
+            vector<string> batch;
+            for (auto &datagram : datagrams_res.get_value()) {
+                batch.push_back(move(std::get<string>(datagram)));
+            }
+            saved_batches.push_back(move(batch));
+        });
+
+    for (const auto &data : {"ab"s, "toolong"s, "toolong"s, "toolong"s}) {
+        ASSERT_EQ(::write(*send_sock_fd, data.data(), data.size()), static_cast<ssize_t>(data.size()));
+    }
+
+    saved_sock_watch_notify_func();
+    ASSERT_EQ(saved_batches, vector<vector<string>>({{"ab"}}));
+    ASSERT_EQ(saved_errors, vector<error_code>({make_error_code(errc::message_size)}));
+
+    saved_sock_watch_notify_func();
+    ASSERT_EQ(saved_batches.size(), 1U);
+    ASSERT_EQ(saved_errors.size(), 2U);
+    ASSERT_EQ(saved_errors[1], make_error_code(errc::message_size));
+
+    acceptor.reset();
+}
+
+
+TEST(NosyncSocketDatagramsAcceptor, CheckBatchedDestroyInHandler)
+{
+    int sock_fds[2];
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, sock_fds), 0);
+    owned_fd recv_sock_fd(sock_fds[0]);
+    owned_fd send_sock_fd(sock_fds[1]);
+
+    function<void()> saved_sock_watch_notify_func;
+    auto mock_sock_watch_handle = make_unique<activity_handle_mock>();
+    EXPECT_CALL(*mock_sock_watch_handle, disable()).WillOnce(Invoke(
+        [&saved_sock_watch_notify_func]() {
+            saved_sock_watch_notify_func = nullptr;
+        }));
+
+    auto mock_watcher = make_shared<fd_watcher_mock>();
+    EXPECT_CALL(*mock_watcher, add_watch_impl(_, Eq(fd_watch_mode::input), _)).WillOnce(Invoke(
+        [&](auto, auto, auto notify_func) {
+            saved_sock_watch_notify_func = move(notify_func);
+            return move(mock_sock_watch_handle);
+        }));
+
+    unsigned handler_calls_count = 0;
+    shared_ptr<interface_type> acceptor;
+    acceptor = make_full_batched_socket_datagrams_acceptor(
+        *mock_watcher, move(recv_sock_fd), 4, 2,
+        [&handler_calls_count, &acceptor](auto) {
+            ++handler_calls_count;
+            acceptor.reset();
+        });
+
+    for (const auto &data : {"ab"s, "toolong"s}) {
+        ASSERT_EQ(::write(*send_sock_fd, data.data(), data.size()), static_cast<ssize_t>(data.size()));
+    }
+
+    auto notify_func = saved_sock_watch_notify_func;
+    notify_func();
+    ASSERT_EQ(handler_calls_count, 1U);
+    ASSERT_FALSE(acceptor);
+}
+
+
+TEST(NosyncSocketDatagramsAcceptor, CheckBatchedZeroBatchSize)
+{
+    int sock_fds[2];
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, sock_fds), 0);
+    owned_fd recv_sock_fd(sock_fds[0]);
+    owned_fd send_sock_fd(sock_fds[1]);
+
+    auto mock_watcher = make_shared<fd_watcher_mock>();
+    EXPECT_CALL(*mock_watcher, add_watch_impl(_, _, _)).Times(0);
+
+    ASSERT_THROW(
+        make_batched_socket_datagrams_acceptor(*mock_watcher, move(recv_sock_fd), 4, 0, [](auto) {}),
+        std::invalid_argument);
+}
@@ -0,0 +1,88 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#include <array>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <nosync/net-utils.h>
+#include <nosync/ppoll-based-event-loop.h>
+#include <nosync/result.h>
+#include <nosync/socket-datagrams-responding-acceptor.h>
+#include <string>
+#include <sys/socket.h>
+#include <utility>
+#include <vector>
+
+using namespace std::chrono_literals;
+using namespace std::string_literals;
+using nosync::bind_local_socket_to_auto_abstract_path;
+using nosync::bytes_io;
+using nosync::get_local_socket_domain;
+using nosync::make_local_abstract_socket_address;
+using nosync::make_ok_result;
+using nosync::make_ppoll_based_event_loop;
+using nosync::make_socket_datagrams_responding_acceptor;
+using nosync::open_datagram_socket;
+using nosync::result;
+using std::array;
+using std::move;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+
+TEST(NosyncSocketDatagramsRespondingAcceptor, RespondViaBoundSocket)
+{
+    auto test_evloop = make_ppoll_based_event_loop();
+
+    auto server_sock_res = open_datagram_socket(get_local_socket_domain());
+    ASSERT_TRUE(server_sock_res.is_ok());
+    auto server_path_res = bind_local_socket_to_auto_abstract_path(*server_sock_res.get_value());
+    ASSERT_TRUE(server_path_res.is_ok());
+
+    auto client_sock_res = open_datagram_socket(get_local_socket_domain());
+    ASSERT_TRUE(client_sock_res.is_ok());
+    ASSERT_TRUE(bind_local_socket_to_auto_abstract_path(*client_sock_res.get_value()).is_ok());
+    const auto &client_sock = client_sock_res.get_value();
+
+    auto server_addr_res = make_local_abstract_socket_address(server_path_res.get_value());
+    ASSERT_TRUE(server_addr_res.is_ok());
+    const auto server_addr_view = server_addr_res.get_value()->get_view();
+    for (const auto &data : {"abc"s, "de"s}) {
+        ASSERT_EQ(
+            ::sendto(*client_sock, data.data(), data.size(), 0, server_addr_view.addr, server_addr_view.addr_size),
+            static_cast<ssize_t>(data.size()));
+    }
+
+    vector<result<void>> write_results;
+    shared_ptr<nosync::interface_type> acceptor;
+    acceptor = make_socket_datagrams_responding_acceptor(
+        *test_evloop, move(server_sock_res.get_value()), 16,
+        [&write_results, &acceptor](shared_ptr<bytes_io> &&io) {
+            io->read_some_bytes(
+                16, 1s,
+                [&write_results, &acceptor, io](auto read_res) {
+                    ASSERT_TRUE(read_res.is_ok());
+                    io->write_bytes(
+                        "re:" + read_res.get_value(),
+                        [&write_results, &acceptor](auto write_res) {
+                            write_results.push_back(write_res);
+                            if (write_results.size() == 2) {
+                                acceptor.reset();
+                            }
+                        });
+                });
+        });
+
+    test_evloop->run_iterations();
+
+    ASSERT_EQ(write_results, vector<result<void>>({make_ok_result(), make_ok_result()}));
+
+    vector<string> responses;
+    array<char, 16> recv_buf;
+    for (int i = 0; i < 2; ++i) {
+        auto recv_retval = ::recv(*client_sock, recv_buf.data(), recv_buf.size(), 0);
+        ASSERT_GE(recv_retval, 0);
+        responses.emplace_back(recv_buf.data(), recv_retval);
+    }
+    ASSERT_EQ(responses, vector<string>({"re:abc", "re:de"}));
+}
@@ -0,0 +1,73 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#include <chrono>
+#include <gtest/gtest.h>
+#include <nosync/func-request-handler.h>
+#include <nosync/manual-event-loop.h>
+#include <nosync/result.h>
+#include <nosync/throttling-request-handler.h>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace ch = std::chrono;
+using namespace std::chrono_literals;
+using nosync::eclock;
+using nosync::make_func_request_handler;
+using nosync::make_ok_result;
+using nosync::make_throttling_request_handler;
+using nosync::make_timeout_error_result;
+using nosync::manual_event_loop;
+using nosync::result;
+using std::make_tuple;
+using std::move;
+using std::tuple;
+using std::vector;
+
+
+TEST(NosyncThrottlingRequestHandler, SpacingTimeoutsAndRemainingTimeout)
+{
+    auto evloop = manual_event_loop::create();
+    const auto start_time = evloop->get_etime();
+
+    vector<tuple<int, ch::time_point<eclock>, ch::nanoseconds>> base_requests;
+    auto handler = make_throttling_request_handler<int, int>(
+        *evloop, 10ns,
+        make_func_request_handler<int, int>(
+            [&](auto &&req, auto timeout, auto &&res_handler) {
+                base_requests.emplace_back(req, evloop->get_etime(), timeout);
+                res_handler(make_ok_result(req));
+            }));
+
+    vector<tuple<int, result<int>>> results;
+    auto make_result_pusher = [&results](int req) {
+        return [&results, req](auto res) {
+            results.emplace_back(req, move(res));
+        };
+    };
+
+    handler->handle_request(1, 100ns, make_result_pusher(1));
+    handler->handle_request(2, 100ns, make_result_pusher(2));
+    handler->handle_request(3, 15ns, make_result_pusher(3));
+    handler->handle_request(4, 100ns, make_result_pusher(4));
+    ASSERT_EQ(base_requests.size(), 1U);
+
+    for (unsigned i = 0; i < 40; ++i) {
+        evloop->process_time_passage(1ns);
+    }
+
+    ASSERT_EQ(
+        base_requests,
+        (vector<tuple<int, ch::time_point<eclock>, ch::nanoseconds>>({
+            make_tuple(1, start_time, 100ns),
+            make_tuple(2, start_time + 10ns, 90ns),
+            make_tuple(4, start_time + 20ns, 80ns),
+        })));
+    ASSERT_EQ(
+        results,
+        (vector<tuple<int, result<int>>>({
+            make_tuple(1, make_ok_result(1)),
+            make_tuple(2, make_ok_result(2)),
+            make_tuple(3, make_timeout_error_result<int>()),
+            make_tuple(4, make_ok_result(4)),
+        })));
+}
@@ -2,7 +2,10 @@
 #include <cstdint>
 #include <gtest/gtest.h>
 #include <nosync/type-utils.h>
+#include <string>
+#include <utility>
 
+using nosync::is_std_hashable;
 using nosync::sizeof_in_atoms;
 using nosync::sizeof_in_bits;
 using nosync::sizeof_sum;
@@ -53,3 +56,14 @@ TEST(NosyncTypeUtils, SizeofSum) {
     ASSERT_EQ((sizeof_sum<char, uint32_t, char>), 6U);
     ASSERT_EQ((sizeof_sum<uint16_t, char, uint64_t, uint32_t>), 15U);
 }
+
+
+TEST(NosyncTypeUtils, IsStdHashable) {
+    struct not_hashable_type {};
+
+    ASSERT_TRUE(is_std_hashable<int>);
+    ASSERT_TRUE(is_std_hashable<std::string>);
+    ASSERT_TRUE(is_std_hashable<void *>);
+    ASSERT_FALSE(is_std_hashable<not_hashable_type>);
+    ASSERT_FALSE((is_std_hashable<std::pair<int, int>>));
+}
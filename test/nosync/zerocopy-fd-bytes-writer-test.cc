@@ -0,0 +1,163 @@
+// This file is part of libnosync library. See LICENSE file for license details.
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <gtest/gtest.h>
+#include <memory>
+#include <nosync/activity-handle.h>
+#include <nosync/fd-utils.h>
+#include <nosync/full-fd-watching-event-loop.h>
+#include <nosync/net-utils.h>
+#include <nosync/ppoll-based-event-loop.h>
+#include <nosync/shared-fd.h>
+#include <nosync/socket-connections-fd-requester.h>
+#include <nosync/zerocopy-fd-bytes-writer.h>
+#include <string>
+#include <sys/socket.h>
+#include <utility>
+#include <vector>
+
+using namespace std::chrono_literals;
+using namespace std::string_literals;
+using nosync::activity_handle;
+using nosync::fd_watch_mode;
+using nosync::full_fd_watching_event_loop;
+using nosync::get_socket_local_address;
+using nosync::make_ipv4_localhost_socket_address;
+using nosync::make_ppoll_based_event_loop;
+using nosync::make_socket_address_copy;
+using nosync::make_zerocopy_fd_bytes_writer;
+using nosync::open_listening_stream_socket;
+using nosync::read_some_bytes_from_fd;
+using nosync::request_socket_connection_fd;
+using nosync::result;
+using nosync::shared_fd;
+using nosync::write_some_bytes_to_fd;
+using std::array;
+using std::function;
+using std::move;
+using std::size_t;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+
+namespace
+{
+
+void read_bytes_until_size(
+    full_fd_watching_event_loop &evloop, const shared_fd &fd, string &read_bytes, size_t expected_size)
+{
+    auto read_watch_handle = std::make_shared<unique_ptr<activity_handle>>();
+    *read_watch_handle = evloop.add_watch(
+        *fd, fd_watch_mode::input,
+        [fd, &read_bytes, expected_size, read_watch_handle]() {
+            auto read_res = read_some_bytes_from_fd(*fd, 1U << 20);
+            if (read_res.is_ok()) {
+                read_bytes += read_res.get_value();
+            }
+            if ((read_res.is_ok() && read_res.get_value().empty()) || read_bytes.size() >= expected_size) {
+                (*read_watch_handle)->disable();
+            }
+        });
+}
+
+
+vector<string> make_test_chunks()
+{
+    vector<string> chunks;
+    for (auto chunk_size : {size_t(3U << 20), size_t(100U), size_t(1U << 16)}) {
+        string chunk;
+        for (size_t i = 0; i < chunk_size; ++i) {
+            chunk.push_back(static_cast<char>('a' + (i + chunks.size()) % 26));
+        }
+        chunks.push_back(move(chunk));
+    }
+
+    return chunks;
+}
+
+
+void check_writer_sends_chunks(full_fd_watching_event_loop &evloop, shared_fd &&write_fd, const shared_fd &read_fd)
+{
+    const auto chunks = make_test_chunks();
+    string expected_bytes;
+    for (const auto &chunk : chunks) {
+        expected_bytes += chunk;
+    }
+
+    string read_bytes;
+    read_bytes_until_size(evloop, read_fd, read_bytes, expected_bytes.size());
+
+    auto writer = make_zerocopy_fd_bytes_writer(evloop, move(write_fd), 4096U);
+    vector<result<void>> saved_results;
+    function<void()> write_next_chunk = [&]() {
+        writer->write_bytes(
+            string(chunks[saved_results.size()]),
+            [&](auto write_res) {
+                saved_results.push_back(move(write_res));
+                if (saved_results.back().is_ok() && saved_results.size() < chunks.size()) {
+                    write_next_chunk();
+                } else {
+                    writer = nullptr;
+                }
+            });
+    };
+    write_next_chunk();
+
+    evloop.run_iterations();
+
+    ASSERT_EQ(saved_results.size(), chunks.size());
+    for (const auto &write_res : saved_results) {
+        ASSERT_TRUE(write_res.is_ok());
+    }
+    ASSERT_EQ(read_bytes.size(), expected_bytes.size());
+    ASSERT_TRUE(read_bytes == expected_bytes);
+}
+
+}
+
+
+TEST(NosyncZerocopyFdBytesWriter, WriteToTcpSocket)
+{
+    auto test_evloop = make_ppoll_based_event_loop();
+
+    auto listen_sock_res = open_listening_stream_socket(make_ipv4_localhost_socket_address(0)->get_view(), 1);
+    ASSERT_TRUE(listen_sock_res.is_ok());
+    const auto &listen_sock = listen_sock_res.get_value();
+
+    auto listen_addr_res = get_socket_local_address(*listen_sock);
+    ASSERT_TRUE(listen_addr_res.is_ok());
+
+    vector<result<shared_fd>> client_sock_results;
+    request_socket_connection_fd(
+        *test_evloop, make_socket_address_copy(listen_addr_res.get_value()->get_view()), 1s,
+        [&client_sock_results](auto sock_res) {
+            client_sock_results.push_back(move(sock_res));
+        });
+    test_evloop->run_iterations();
+    ASSERT_EQ(client_sock_results.size(), 1U);
+    ASSERT_TRUE(client_sock_results.front().is_ok());
+
+    shared_fd server_sock(::accept4(*listen_sock, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC));
+    ASSERT_GE(*server_sock, 0);
+
+    const auto unread_bytes = "never read by the writer side"s;
+    auto write_res = write_some_bytes_to_fd(*server_sock, unread_bytes);
+    ASSERT_TRUE(write_res.is_ok());
+    ASSERT_EQ(write_res.get_value(), unread_bytes.size());
+
+    check_writer_sends_chunks(*test_evloop, move(client_sock_results.front().get_value()), server_sock);
+}
+
+
+TEST(NosyncZerocopyFdBytesWriter, FallbackForUnsupportedSocket)
+{
+    auto test_evloop = make_ppoll_based_event_loop();
+
+    array<int, 2> sock_fds;
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, sock_fds.data()), 0);
+
+    check_writer_sends_chunks(*test_evloop, shared_fd(sock_fds[0]), shared_fd(sock_fds[1]));
+}